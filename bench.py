@@ -0,0 +1,281 @@
+#!/usr/bin/env python3
+"""Benchmark suite: boots the kernel headless and reports timings as JSON.
+
+Phase 1 boots with "-append bench": the kernel runs dedicated movdbz
+programs (countdown, branch-heavy, resume storm, and the countdown on
+every CPU at once) and reports TSC cycle counts as BENCH: lines, which
+are timed here to get wall-clock rates.
+
+Phase 2 boots the normal REPL and measures keystroke-echo latency and
+response relay throughput over the serial wire protocol.
+
+With --accel kvm the guest runs under KVM. --compare also runs phase 1
+under TCG and reports the KVM speedup of each cascade benchmark.
+
+Usage:
+  make bench
+  make bench-kvm
+  python3 bench.py [--output FILE] [--smp N] [--accel tcg|kvm] [--compare]
+"""
+
+import argparse
+import hashlib
+import json
+import os
+import socket
+import subprocess
+import sys
+import time
+
+PORT = 4323
+KERNEL = "build/pagefault_claude"
+TIMEOUT = 120
+ECHO_CHARS = 32
+RELAY_BYTES = 4096
+SMP = 1
+
+
+class Guest:
+    """A headless QEMU guest with its serial port on TCP."""
+
+    def __init__(self, port, append=None, smp=SMP, accel="tcg"):
+        cmd = [
+            "qemu-system-i386",
+            "-kernel", KERNEL,
+            "-serial", f"tcp:127.0.0.1:{port},server=on,wait=on",
+            "-monitor", "none",
+            "-display", "none",
+            "-m", "32",
+            "-smp", str(smp),
+            "-accel", accel,
+            "-device", "isa-debug-exit,iobase=0x501,iosize=0x04",
+            "-no-reboot",
+        ]
+        if append:
+            cmd += ["-append", append]
+        self.qemu = subprocess.Popen(cmd, stdout=subprocess.DEVNULL,
+                                     stderr=subprocess.DEVNULL)
+        self.sock = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+        for _ in range(20):
+            try:
+                self.sock.connect(("127.0.0.1", port))
+                break
+            except ConnectionRefusedError:
+                time.sleep(0.5)
+        else:
+            self.close()
+            raise ConnectionError("could not connect to QEMU serial")
+        self.sock.settimeout(TIMEOUT)
+        self.buf = b""
+
+    def read(self, n=1):
+        while len(self.buf) < n:
+            data = self.sock.recv(4096)
+            if not data:
+                raise ConnectionError("closed")
+            self.buf += data
+        out, self.buf = self.buf[:n], self.buf[n:]
+        return out
+
+    def readline(self):
+        while b"\n" not in self.buf:
+            data = self.sock.recv(4096)
+            if not data:
+                raise ConnectionError("closed")
+            self.buf += data
+        line, self.buf = self.buf.split(b"\n", 1)
+        line = line.decode(errors="replace")
+        if line.startswith("ERROR:"):       # The kernel stopped (boot_fail())
+            raise ConnectionError(f"guest stopped: {line[len('ERROR:'):]}")
+        return line
+
+    def wait_for(self, prefix):
+        while True:
+            line = self.readline()
+            if line.startswith(prefix):
+                return line
+
+    def close(self):
+        self.sock.close()
+        self.qemu.kill()
+        self.qemu.wait()
+
+
+def parse_fields(line):
+    """'BENCH:name a=1 b=2' -> ('name', {'a': 1, 'b': 2})"""
+    words = line[len("BENCH:"):].split()
+    fields = {}
+    for w in words[1:]:
+        k, _, v = w.partition("=")
+        fields[k] = int(v)
+    return words[0], fields
+
+
+def bench_cascades(smp, accel):
+    """Run the in-kernel movdbz benchmarks."""
+    guest = Guest(PORT, append="bench", smp=smp, accel=accel)
+    results = {}
+    tsc_hz = []
+    try:
+        while True:
+            line = guest.readline()
+            if line == "BENCH:done":
+                break
+            if line.startswith("ACCEL:"):     # "ACCEL:<name> selftest=ok"
+                name, _, selftest = line[len("ACCEL:"):].partition(" selftest=")
+                results["accel"] = name
+                results["selftest"] = selftest
+                continue
+            if not line.startswith("BENCH:"):
+                continue
+            name, fields = parse_fields(line)
+            if not fields:          # "<name> start"
+                start = time.monotonic()
+                continue
+            wall = time.monotonic() - start
+            movdbz = fields["movdbz"]
+            cycles = fields["cycles"]
+            tsc_hz.append(cycles / wall)
+            entry = {
+                "wall_s": round(wall, 6),
+                "cycles": cycles,
+            }
+            if name == "resume":
+                entry.update({
+                    "resumes": movdbz,
+                    "resumes_per_sec": round(movdbz / wall),
+                    "latency_us": round(wall / movdbz * 1e6, 3),
+                    "latency_cycles_avg": cycles // movdbz,
+                    "latency_cycles_min": fields["min"],
+                    "latency_cycles_max": fields["max"],
+                })
+            else:
+                entry.update({
+                    "movdbz": movdbz,
+                    "movdbz_per_sec": round(movdbz / wall),
+                    "task_switches": fields["switches"],
+                    "task_switches_per_sec": round(fields["switches"] / wall),
+                    "switches_per_movdbz": round(fields["switches"] / movdbz, 3),
+                    "cycles_per_movdbz": round(cycles / movdbz, 1),
+                })
+                if "cpus" in fields:
+                    entry["cpus"] = fields["cpus"]
+            results[name] = entry
+    finally:
+        guest.close()
+    if tsc_hz:
+        results["tsc_hz_estimate"] = round(sum(tsc_hz) / len(tsc_hz))
+    return results
+
+
+def speedup(fast, base):
+    """Ratio of each benchmark's rate between two bench_cascades() runs."""
+    out = {}
+    for name, entry in fast.items():
+        if not isinstance(entry, dict) or name not in base:
+            continue
+        key = "resumes_per_sec" if "resumes_per_sec" in entry else "movdbz_per_sec"
+        out[name] = round(entry[key] / base[name][key], 2)
+    return out
+
+
+def bench_repl(smp, accel):
+    """Time keystroke echo and response relay through the real REPL."""
+    guest = Guest(PORT, smp=smp, accel=accel)
+    try:
+        guest.wait_for("READY")
+        guest.wait_for("CAPS:")
+
+        # Keystroke echo: each byte costs one bridge exit + resume
+        latencies = []
+        for i in range(ECHO_CHARS):
+            c = bytes([ord("a") + i % 26])
+            t0 = time.monotonic()
+            guest.sock.sendall(c)
+            while guest.read(1) != c:
+                pass
+            latencies.append(time.monotonic() - t0)
+        guest.sock.sendall(b"\n")
+        guest.wait_for("Q:")
+
+        # Response relay: answer is rendered and echoed back as "Claude: ..."
+        payload = (b"0123456789abcdef" * (RELAY_BYTES // 16 + 1))[:RELAY_BYTES]
+        t0 = time.monotonic()
+        guest.sock.sendall(b"A:" + payload + b"\x04")
+        guest.wait_for("Claude: ")
+        relay = time.monotonic() - t0
+
+        guest.sock.sendall(b"quit\n")
+        guest.wait_for("BYE")
+    finally:
+        guest.close()
+
+    latencies.sort()
+    return {
+        "keystroke_echo": {
+            "samples": len(latencies),
+            "latency_ms_avg": round(sum(latencies) / len(latencies) * 1e3, 3),
+            "latency_ms_p50": round(latencies[len(latencies) // 2] * 1e3, 3),
+            "latency_ms_max": round(latencies[-1] * 1e3, 3),
+        },
+        "response_relay": {
+            "bytes": RELAY_BYTES,
+            "wall_s": round(relay, 6),
+            "bytes_per_sec": round(RELAY_BYTES / relay),
+        },
+    }
+
+
+def main():
+    parser = argparse.ArgumentParser(description="PageFault Claude benchmarks")
+    parser.add_argument("--output", help="Write JSON here instead of stdout")
+    parser.add_argument("--smp", type=int, default=SMP,
+                        help=f"Guest vCPUs (default {SMP})")
+    parser.add_argument("--accel", choices=["tcg", "kvm"], default="tcg",
+                        help="QEMU accelerator (default tcg)")
+    parser.add_argument("--compare", action="store_true",
+                        help="Also run the cascade benchmarks under TCG "
+                             "and report the speedup")
+    args = parser.parse_args()
+
+    if not os.path.exists(KERNEL):
+        print(f"ERROR: {KERNEL} not found. Run 'make' first.", file=sys.stderr)
+        sys.exit(1)
+    if args.accel == "kvm" and not os.access("/dev/kvm", os.R_OK | os.W_OK):
+        print("ERROR: /dev/kvm is not accessible.", file=sys.stderr)
+        sys.exit(1)
+
+    with open(KERNEL, "rb") as f:
+        kernel_sha = hashlib.sha256(f.read()).hexdigest()
+    qemu_version = subprocess.run(["qemu-system-i386", "--version"],
+                                  capture_output=True, text=True).stdout
+    report = {
+        "kernel_sha256": kernel_sha,
+        "qemu_version": qemu_version.splitlines()[0] if qemu_version else None,
+        "timestamp": int(time.time()),
+        "smp": args.smp,
+        "accel": args.accel,
+    }
+
+    try:
+        print("Running cascade benchmarks...", file=sys.stderr)
+        report["cascade"] = bench_cascades(args.smp, args.accel)
+        if args.compare and args.accel != "tcg":
+            print("Running cascade benchmarks under TCG...", file=sys.stderr)
+            report["cascade_tcg"] = bench_cascades(args.smp, "tcg")
+            report["speedup"] = speedup(report["cascade"], report["cascade_tcg"])
+        print("Running REPL benchmarks...", file=sys.stderr)
+        report["repl"] = bench_repl(args.smp, args.accel)
+    except (socket.timeout, ConnectionError) as e:
+        print(f"FAIL: {e}", file=sys.stderr)
+        sys.exit(1)
+
+    out = json.dumps(report, indent=2)
+    if args.output:
+        with open(args.output, "w") as f:
+            f.write(out + "\n")
+    print(out)
+
+
+if __name__ == "__main__":
+    main()
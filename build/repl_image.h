@@ -0,0 +1,794 @@
+/* Generated by tools/wmimage.c -- do not edit. */
+
+#ifndef REPL_IMAGE_H
+#define REPL_IMAGE_H
+
+#include "weirdmachine.h"
+
+static const uint32_t repl_byte_image_state[] = {
+    0x3, 0x3, 0x4, 0x8, 0x4, 0x31, 0x29, 0xffffffff,
+    0x0, 0x0, 0x2, 0x4, 0x5, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x3, 0x4, 0x5, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x2ff83ff8, 0x180018, 0x2ff82ff8, 0x1ff81ff8, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x5, 0x4, 0x6, 0x7, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x5002, 0x260023, 0x1000000, 0x90009, 0x5002,
+    0x270023, 0x5002, 0x280023, 0x2002002, 0x80009, 0x1001001, 0x80009, 0x1003003,
+    0x80009, 0x1004004, 0x80009, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0,
+};
+static const uint32_t repl_byte_image_runs[] = {
+    0x00400, 1, 0x1000003,
+    0x00800, 5, 0x1003003, 0x1004003, 0x1005003, 0x1006003, 0x1007003,
+    0x00c02, 6, 0xffff, 0xcf9a00, 0xffff, 0xcf9200, 0xf0000067, 0x4089ff,
+    0x013fe, 2, 0xffd00067, 0x408940,
+    0x017fe, 2, 0xffd00067, 0x408941,
+    0x01bfe, 2, 0xffd00067, 0x408942,
+    0x01ffe, 2, 0xffd00067, 0x408943,
+    0x02002, 1, 0x4,
+    0x02006, 6, 0x10, 0x8, 0x10, 0x10, 0x10, 0x10,
+    0x02406, 6, 0x10, 0x8, 0x10, 0x10, 0x10, 0x10,
+    0x02810, 2, 0x3ff80000, 0xe500,
+    0x0281c, 2, 0x2ff80000, 0xe500,
+    0x02c10, 2, 0x180000, 0xe500,
+    0x02c1c, 2, 0x180000, 0xe500,
+    0x03010, 2, 0x2ff80000, 0xe500,
+    0x0301c, 2, 0x2ff80000, 0xe500,
+    0x03410, 2, 0x1ff80000, 0xe500,
+    0x0341c, 2, 0x1ff80000, 0xe500,
+    0x08c06, 6, 0x10, 0x8, 0x10, 0x10, 0x10, 0x10,
+    0x09006, 6, 0x10, 0x8, 0x10, 0x10, 0x10, 0x10,
+    0x09406, 6, 0x10, 0x8, 0x10, 0x10, 0x10, 0x10,
+    0x09802, 1, 0x8,
+    0x09806, 6, 0x10, 0x8, 0x10, 0x10, 0x10, 0x10,
+    0x09c02, 1, 0x10,
+    0x09c06, 6, 0x10, 0x8, 0x10, 0x10, 0x10, 0x10,
+    0x0a002, 1, 0x14,
+    0x0a006, 6, 0x10, 0x8, 0x10, 0x10, 0x10, 0x10,
+    0x0a400, 8, 0x1001003, 0x102a003, 0x1002003, 0xc00183, 0x1000183, 0x1400183, 0x1800183, 0x1c00183,
+    0x0a800, 1, 0x100d003,
+    0x0a81f, 2, 0x1042003, 0x1008003,
+    0x0ac00, 8, 0x1001003, 0x102c003, 0x1002003, 0xc00183, 0x1000183, 0x1400183, 0x1800183, 0x1c00183,
+    0x0b000, 1, 0x100c003,
+    0x0b02f, 2, 0x103f003, 0x1008003,
+    0x0b400, 8, 0x1001003, 0x102e003, 0x1002003, 0xc00183, 0x1000183, 0x1400183, 0x1800183, 0x1c00183,
+    0x0b800, 1, 0x100d003,
+    0x0b81f, 2, 0x1045003, 0x1008003,
+    0x0bc00, 8, 0x1001003, 0x1030003, 0x1002003, 0xc00183, 0x1000183, 0x1400183, 0x1800183, 0x1c00183,
+    0x0c000, 1, 0x100d003,
+    0x0c01f, 2, 0x1048003, 0x1008003,
+    0x0c400, 8, 0x1001003, 0x1032003, 0x1002003, 0xc00183, 0x1000183, 0x1400183, 0x1800183, 0x1c00183,
+    0x0c800, 1, 0x100a003,
+    0x0c80f, 2, 0x1004003, 0x1023003,
+    0x0c81f, 2, 0x1036003, 0x1009003,
+    0x0c82f, 2, 0x103f003, 0x1008003,
+    0x0cffb, 13, 0x1031000, 0xfffefff, 0x2, 0xffd00067, 0x408940, 0x1001003, 0x1035003, 0x1002003, 0xc00183, 0x1000183, 0x1400183, 0x1800183, 0x1c00183,
+    0x0d400, 1, 0x100b003,
+    0x0d41f, 2, 0x1005003, 0x1009003,
+    0x0dbfb, 13, 0x1034000, 0xfffefff, 0x2, 0xffd00067, 0x408941, 0x1001003, 0x1038003, 0x1002003, 0xc00183, 0x1000183, 0x1400183, 0x1800183, 0x1c00183,
+    0x0e000, 1, 0x100a003,
+    0x0e00f, 2, 0x1004003, 0x1023003,
+    0x0e01f, 2, 0x1036003, 0x1009003,
+    0x0e02f, 2, 0x103f003, 0x1008003,
+    0x0e7fb, 13, 0x1037000, 0xfffefff, 0x2, 0xffd00067, 0x408940, 0x1001003, 0x103b003, 0x1002003, 0xc00183, 0x1000183, 0x1400183, 0x1800183, 0x1c00183,
+    0x0ec00, 1, 0x100a003,
+    0x0ec0f, 2, 0x1004003, 0x1023003,
+    0x0ec1f, 2, 0x1036003, 0x1009003,
+    0x0ec2f, 2, 0x103f003, 0x1008003,
+    0x0f3fb, 13, 0x103a000, 0xfffefff, 0x2, 0xffd00067, 0x408940, 0x1001003, 0x103e003, 0x1002003, 0xc00183, 0x1000183, 0x1400183, 0x1800183, 0x1c00183,
+    0x0f800, 1, 0x100c003,
+    0x0f81f, 2, 0x1036003, 0x1009003,
+    0x0f82f, 2, 0x1006003, 0x1009003,
+    0x0fffb, 13, 0x103d000, 0xfffefff, 0x2, 0xffd00067, 0x408942, 0x1001003, 0x1041003, 0x1002003, 0xc00183, 0x1000183, 0x1400183, 0x1800183, 0x1c00183,
+    0x10400, 1, 0x100d003,
+    0x1040f, 2, 0x1033003, 0x1026003,
+    0x1041f, 2, 0x1005003, 0x1009003,
+    0x10bfb, 13, 0x1040000, 0xfffefff, 0x2, 0xffd00067, 0x408941, 0x1001003, 0x1044003, 0x1002003, 0xc00183, 0x1000183, 0x1400183, 0x1800183, 0x1c00183,
+    0x11000, 1, 0x100d003,
+    0x1100f, 2, 0x1039003, 0x1027003,
+    0x1101f, 2, 0x1005003, 0x1009003,
+    0x117fb, 13, 0x1043000, 0xfffefff, 0x2, 0xffd00067, 0x408941, 0x1001003, 0x1047003, 0x1002003, 0xc00183, 0x1000183, 0x1400183, 0x1800183, 0x1c00183,
+    0x11c00, 1, 0x100d003,
+    0x11c0f, 2, 0x103c003, 0x1028003,
+    0x11c1f, 2, 0x1005003, 0x1009003,
+    0x123fb, 5, 0x1046000, 0xfffefff, 0x2, 0xffd00067, 0x408941,
+    0, 0,
+};
+static const struct wm_image repl_byte_image = {
+    WM_IMAGE_VERSION, 73, 0xf1bb1621, 2467,
+    repl_byte_image_state, repl_byte_image_runs,
+};
+
+static const uint32_t repl_line_image_state[] = {
+    0x3, 0x3, 0x4, 0x8, 0x4, 0x31, 0x29, 0xffffffff,
+    0x0, 0x0, 0x6, 0x4, 0x5, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x3, 0x4, 0x5, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x2ff83ff8, 0x180018, 0x2ff82ff8, 0x1ff81ff8, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x5, 0x4, 0x6, 0x7, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x5002, 0x260023, 0x1000000, 0x90009, 0x5002,
+    0x270023, 0x5002, 0x280023, 0x2002002, 0x80009, 0x1001001, 0x80009, 0x1003003,
+    0x80009, 0x1004004, 0x80009, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001, 0x0, 0x1001,
+    0x0, 0x1001, 0x0,
+};
+static const uint32_t repl_line_image_runs[] = {
+    0x00400, 1, 0x1000003,
+    0x00800, 5, 0x1003003, 0x1004003, 0x1005003, 0x1006003, 0x1007003,
+    0x00c02, 6, 0xffff, 0xcf9a00, 0xffff, 0xcf9200, 0xf0000067, 0x4089ff,
+    0x013fe, 2, 0xffd00067, 0x408940,
+    0x017fe, 2, 0xffd00067, 0x408941,
+    0x01bfe, 2, 0xffd00067, 0x408942,
+    0x01ffe, 2, 0xffd00067, 0x408943,
+    0x02002, 1, 0x4,
+    0x02006, 6, 0x10, 0x8, 0x10, 0x10, 0x10, 0x10,
+    0x02406, 6, 0x10, 0x8, 0x10, 0x10, 0x10, 0x10,
+    0x02810, 2, 0x3ff80000, 0xe500,
+    0x0281c, 2, 0x2ff80000, 0xe500,
+    0x02c10, 2, 0x180000, 0xe500,
+    0x02c1c, 2, 0x180000, 0xe500,
+    0x03010, 2, 0x2ff80000, 0xe500,
+    0x0301c, 2, 0x2ff80000, 0xe500,
+    0x03410, 2, 0x1ff80000, 0xe500,
+    0x0341c, 2, 0x1ff80000, 0xe500,
+    0x08c06, 6, 0x10, 0x8, 0x10, 0x10, 0x10, 0x10,
+    0x09006, 6, 0x10, 0x8, 0x10, 0x10, 0x10, 0x10,
+    0x09406, 6, 0x10, 0x8, 0x10, 0x10, 0x10, 0x10,
+    0x09802, 1, 0x18,
+    0x09806, 6, 0x10, 0x8, 0x10, 0x10, 0x10, 0x10,
+    0x09c02, 1, 0x10,
+    0x09c06, 6, 0x10, 0x8, 0x10, 0x10, 0x10, 0x10,
+    0x0a002, 1, 0x14,
+    0x0a006, 6, 0x10, 0x8, 0x10, 0x10, 0x10, 0x10,
+    0x0a400, 8, 0x1001003, 0x102a003, 0x1002003, 0xc00183, 0x1000183, 0x1400183, 0x1800183, 0x1c00183,
+    0x0a800, 1, 0x100d003,
+    0x0a81f, 2, 0x1042003, 0x1008003,
+    0x0ac00, 8, 0x1001003, 0x102c003, 0x1002003, 0xc00183, 0x1000183, 0x1400183, 0x1800183, 0x1c00183,
+    0x0b000, 1, 0x100c003,
+    0x0b02f, 2, 0x103f003, 0x1008003,
+    0x0b400, 8, 0x1001003, 0x102e003, 0x1002003, 0xc00183, 0x1000183, 0x1400183, 0x1800183, 0x1c00183,
+    0x0b800, 1, 0x100d003,
+    0x0b81f, 2, 0x1045003, 0x1008003,
+    0x0bc00, 8, 0x1001003, 0x1030003, 0x1002003, 0xc00183, 0x1000183, 0x1400183, 0x1800183, 0x1c00183,
+    0x0c000, 1, 0x100d003,
+    0x0c01f, 2, 0x1048003, 0x1008003,
+    0x0c400, 8, 0x1001003, 0x1032003, 0x1002003, 0xc00183, 0x1000183, 0x1400183, 0x1800183, 0x1c00183,
+    0x0c800, 1, 0x100a003,
+    0x0c80f, 2, 0x1004003, 0x1023003,
+    0x0c81f, 2, 0x1036003, 0x1009003,
+    0x0c82f, 2, 0x103f003, 0x1008003,
+    0x0cffb, 13, 0x1031000, 0xfffefff, 0x2, 0xffd00067, 0x408940, 0x1001003, 0x1035003, 0x1002003, 0xc00183, 0x1000183, 0x1400183, 0x1800183, 0x1c00183,
+    0x0d400, 1, 0x100b003,
+    0x0d41f, 2, 0x1005003, 0x1009003,
+    0x0dbfb, 13, 0x1034000, 0xfffefff, 0x2, 0xffd00067, 0x408941, 0x1001003, 0x1038003, 0x1002003, 0xc00183, 0x1000183, 0x1400183, 0x1800183, 0x1c00183,
+    0x0e000, 1, 0x100a003,
+    0x0e00f, 2, 0x1004003, 0x1023003,
+    0x0e01f, 2, 0x1036003, 0x1009003,
+    0x0e02f, 2, 0x103f003, 0x1008003,
+    0x0e7fb, 13, 0x1037000, 0xfffefff, 0x2, 0xffd00067, 0x408940, 0x1001003, 0x103b003, 0x1002003, 0xc00183, 0x1000183, 0x1400183, 0x1800183, 0x1c00183,
+    0x0ec00, 1, 0x100a003,
+    0x0ec0f, 2, 0x1004003, 0x1023003,
+    0x0ec1f, 2, 0x1036003, 0x1009003,
+    0x0ec2f, 2, 0x103f003, 0x1008003,
+    0x0f3fb, 13, 0x103a000, 0xfffefff, 0x2, 0xffd00067, 0x408940, 0x1001003, 0x103e003, 0x1002003, 0xc00183, 0x1000183, 0x1400183, 0x1800183, 0x1c00183,
+    0x0f800, 1, 0x100c003,
+    0x0f81f, 2, 0x1036003, 0x1009003,
+    0x0f82f, 2, 0x1006003, 0x1009003,
+    0x0fffb, 13, 0x103d000, 0xfffefff, 0x2, 0xffd00067, 0x408942, 0x1001003, 0x1041003, 0x1002003, 0xc00183, 0x1000183, 0x1400183, 0x1800183, 0x1c00183,
+    0x10400, 1, 0x100d003,
+    0x1040f, 2, 0x1033003, 0x1026003,
+    0x1041f, 2, 0x1005003, 0x1009003,
+    0x10bfb, 13, 0x1040000, 0xfffefff, 0x2, 0xffd00067, 0x408941, 0x1001003, 0x1044003, 0x1002003, 0xc00183, 0x1000183, 0x1400183, 0x1800183, 0x1c00183,
+    0x11000, 1, 0x100d003,
+    0x1100f, 2, 0x1039003, 0x1027003,
+    0x1101f, 2, 0x1005003, 0x1009003,
+    0x117fb, 13, 0x1043000, 0xfffefff, 0x2, 0xffd00067, 0x408941, 0x1001003, 0x1047003, 0x1002003, 0xc00183, 0x1000183, 0x1400183, 0x1800183, 0x1c00183,
+    0x11c00, 1, 0x100d003,
+    0x11c0f, 2, 0x103c003, 0x1028003,
+    0x11c1f, 2, 0x1005003, 0x1009003,
+    0x123fb, 5, 0x1046000, 0xfffefff, 0x2, 0xffd00067, 0x408941,
+    0, 0,
+};
+static const struct wm_image repl_line_image = {
+    WM_IMAGE_VERSION, 73, 0xc8b29d91, 2467,
+    repl_line_image_state, repl_line_image_runs,
+};
+
+#endif /* REPL_IMAGE_H */
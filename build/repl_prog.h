@@ -0,0 +1,55 @@
+/* Generated by tools/wmc.py from kernel/repl.wm -- do not edit. */
+
+#ifndef REPL_PROG_H
+#define REPL_PROG_H
+
+#include "weirdmachine.h"
+
+#define REPL_REG_CMD 0
+#define REPL_REG_DATA 1
+#define REPL_REG_TEMP 2
+#define REPL_READ 0
+#define REPL_SEND 2
+#define REPL_RECV 3
+#define REPL_LOOP 0
+#define REPL_NUM_INSTS 4
+
+/* repl_byte: 7 -> 4 movdbz after optimization
+ *     0: movdbz cmd, =1, 1, 1
+ *     1: movdbz _, _, exit, exit
+ *     2: movdbz cmd, =3, 1, 1
+ *     3: movdbz cmd, =4, 1, 1
+ */
+static const uint32_t repl_byte_consts[] = { 2, 4, 5 };
+static const struct wm_inst repl_byte_insts[] = {
+    { 0, WM_REG_CONST(0), 1, 1 },
+    { WM_REG_DISCARD, WM_REG_DISCARD, -1, -1 },
+    { 0, WM_REG_CONST(1), 1, 1 },
+    { 0, WM_REG_CONST(2), 1, 1 },
+};
+static const struct wm_program repl_byte_program = {
+    3, 3, repl_byte_consts,
+    4, repl_byte_insts,
+    0, 0,
+};
+
+/* repl_line: 7 -> 4 movdbz after optimization
+ *     0: movdbz cmd, =5, 1, 1
+ *     1: movdbz _, _, exit, exit
+ *     2: movdbz cmd, =3, 1, 1
+ *     3: movdbz cmd, =4, 1, 1
+ */
+static const uint32_t repl_line_consts[] = { 6, 4, 5 };
+static const struct wm_inst repl_line_insts[] = {
+    { 0, WM_REG_CONST(0), 1, 1 },
+    { WM_REG_DISCARD, WM_REG_DISCARD, -1, -1 },
+    { 0, WM_REG_CONST(1), 1, 1 },
+    { 0, WM_REG_CONST(2), 1, 1 },
+};
+static const struct wm_program repl_line_program = {
+    3, 3, repl_line_consts,
+    4, repl_line_insts,
+    0, 0,
+};
+
+#endif /* REPL_PROG_H */
@@ -0,0 +1,380 @@
+#!/usr/bin/env python3
+"""Fleet load generator: scripted REPL sessions across N guests.
+
+Boots N headless guests, each with its serial port on its own TCP port,
+and relays every guest's serial to one multiplexing proxy running in
+listen mode (claude_proxy.py --listen). Between the two, the relay types
+prompts from a corpus into each guest as if over the keyboard fallback,
+one at a time, and watches both directions:
+
+  sent     the prompt's newline goes to the guest
+  ttfb     the first byte of the answer reaches the guest
+  done     the kernel has the whole answer: its ACK: line, or the end
+           of its "Claude: ..." echo when answers are echoed
+
+Reports queries/sec over the whole fleet, p50/p99 end-to-end latency
+(sent to done) and time to first byte, and the CPU time each QEMU
+process and the proxy used, as JSON like bench.py.
+
+The proxy is started here: --proxy mock answers with --no-api, cache
+asks the API through a response cache (every guest runs the corpus in
+the same order, so after the first guest most queries hit), and api
+asks the API every time. --proxy external leaves it to you; start
+claude_proxy.py --listen on --proxy-port first.
+
+Usage:
+  make fleet
+  python3 fleet.py [--guests N] [--queries N] [--corpus FILE]
+                   [--proxy mock|cache|api|external] [--output FILE]
+"""
+
+import argparse
+import asyncio
+import hashlib
+import json
+import os
+import subprocess
+import sys
+import time
+
+KERNEL = "build/pagefault_claude"
+PROXY = "proxy/claude_proxy.py"
+PROXY_LOG = "build/fleet_proxy.log"
+CACHE = "build/fleet_cache.db"
+BASE_PORT = 4500
+PROXY_PORT = 4499
+TIMEOUT = 120
+SMP = 1
+
+SOH = 0x01
+
+CORPUS = [
+    "What is a page fault?",
+    "Explain the x86 task state segment in two sentences.",
+    "Why does a double fault not become a triple fault here?",
+    "Name three one-instruction computers.",
+    "What does movdbz compute?",
+    "How fast is a 115200 baud serial line in bytes per second?",
+    "Write a haiku about the MMU.",
+    "What is the busy bit in a TSS descriptor?",
+]
+
+CLK_TCK = os.sysconf("SC_CLK_TCK")
+
+
+def cpu_seconds(pid):
+    """User plus system CPU time of a process so far."""
+    try:
+        with open(f"/proc/{pid}/stat") as f:
+            fields = f.read().rsplit(")", 1)[1].split()
+    except OSError:
+        return 0.0
+    return (int(fields[11]) + int(fields[12])) / CLK_TCK
+
+
+def percentiles(samples):
+    if not samples:
+        return None
+    s = sorted(samples)
+    pick = lambda p: s[min(len(s) - 1, int(p / 100 * len(s)))]
+    return {
+        "samples": len(s),
+        "ms_avg": round(sum(s) / len(s) * 1e3, 3),
+        "ms_p50": round(pick(50) * 1e3, 3),
+        "ms_p99": round(pick(99) * 1e3, 3),
+        "ms_max": round(s[-1] * 1e3, 3),
+    }
+
+
+class LineParser:
+    """Splits the guest -> proxy stream into text lines, skipping frames."""
+
+    def __init__(self):
+        self.buf = b""
+
+    def feed(self, data):
+        self.buf += data
+        lines = []
+        while self.buf:
+            if self.buf[0] == SOH:
+                if len(self.buf) < 6:
+                    break
+                end = 6 + int.from_bytes(self.buf[2:4], "little")
+                if len(self.buf) < end:
+                    break
+                self.buf = self.buf[end:]
+                continue
+            i = self.buf.find(b"\n")
+            if i < 0:
+                break
+            lines.append(self.buf[:i].decode(errors="replace"))
+            self.buf = self.buf[i + 1:]
+        return lines
+
+
+class Guest:
+    """One headless guest whose serial is relayed to the proxy."""
+
+    def __init__(self, index, port, args):
+        self.index = index
+        self.port = port
+        cmd = [
+            "qemu-system-i386",
+            "-kernel", KERNEL,
+            "-serial", f"tcp:127.0.0.1:{port},server=on,wait=on",
+            "-monitor", "none",
+            "-display", "none",
+            "-m", "32",
+            "-smp", str(args.smp),
+            "-accel", args.accel,
+            "-no-reboot",
+        ]
+        if args.line:
+            cmd += ["-append", "line"]
+        self.qemu = subprocess.Popen(cmd, stdout=subprocess.DEVNULL,
+                                     stderr=subprocess.DEVNULL)
+        self.events = asyncio.Queue()   # ("line", text, t) and ("closed", None, t)
+        self.first_byte = None          # Time of the first answer byte since `armed`
+        self.armed = False
+        self.latency = []
+        self.ttfb = []
+        self.errors = 0
+        self.tasks = []
+
+    async def connect(self, proxy_port):
+        for _ in range(40):
+            try:
+                self.guest_r, self.guest_w = await asyncio.open_connection(
+                    "127.0.0.1", self.port)
+                break
+            except OSError:
+                await asyncio.sleep(0.5)
+        else:
+            raise ConnectionError(f"guest {self.index}: could not connect to QEMU serial")
+        self.proxy_r, self.proxy_w = await asyncio.open_connection("127.0.0.1", proxy_port)
+        self.tasks = [asyncio.create_task(self.from_guest()),
+                      asyncio.create_task(self.from_proxy())]
+
+    async def from_guest(self):
+        parser = LineParser()
+        while data := await self.guest_r.read(4096):
+            self.proxy_w.write(data)
+            now = time.monotonic()
+            for line in parser.feed(data):
+                self.events.put_nowait(("line", line, now))
+            await self.proxy_w.drain()
+        self.events.put_nowait(("closed", None, time.monotonic()))
+
+    async def from_proxy(self):
+        while data := await self.proxy_r.read(4096):
+            if self.armed and self.first_byte is None:
+                self.first_byte = time.monotonic()
+            self.guest_w.write(data)
+            await self.guest_w.drain()
+
+    async def wait_line(self, prefixes, timeout=TIMEOUT):
+        """Wait for a guest line starting with one of prefixes."""
+        deadline = time.monotonic() + timeout
+        while True:
+            kind, line, t = await asyncio.wait_for(
+                self.events.get(), max(0.0, deadline - time.monotonic()))
+            if kind == "closed":
+                raise ConnectionError(f"guest {self.index}: serial closed")
+            if kind == "line" and line.startswith(prefixes):
+                return line, t
+
+    async def query(self, prompt):
+        """Type one prompt and wait until the kernel has the whole answer."""
+        self.first_byte = None
+        self.armed = True
+        t0 = time.monotonic()
+        self.guest_w.write(prompt.encode() + b"\n")
+        await self.guest_w.drain()
+        _, done = await self.wait_line(("ACK:", "Claude: "))
+        self.armed = False
+        self.latency.append(done - t0)
+        if self.first_byte is not None:
+            self.ttfb.append(self.first_byte - t0)
+
+    async def close(self):
+        for task in self.tasks:
+            task.cancel()
+        for w in ("guest_w", "proxy_w"):
+            if hasattr(self, w):
+                getattr(self, w).close()
+        self.qemu.kill()
+        self.qemu.wait()
+
+
+async def run_guest(guest, prompts, think):
+    for prompt in prompts:
+        try:
+            await guest.query(prompt)
+        except asyncio.TimeoutError:
+            guest.errors += 1
+            print(f"guest {guest.index}: timed out on {prompt!r}", file=sys.stderr)
+            return
+        if think:
+            await asyncio.sleep(think)
+    guest.guest_w.write(b"quit\n")
+    await guest.guest_w.drain()
+    try:
+        await guest.wait_line(("BYE",), timeout=30)
+    except (asyncio.TimeoutError, ConnectionError):
+        pass
+
+
+def start_proxy(args):
+    if args.proxy == "external":
+        return None
+    cmd = [sys.executable, PROXY, "--listen", str(args.proxy_port),
+           "--workers", str(args.workers or args.guests)]
+    if args.proxy == "mock":
+        cmd.append("--no-api")
+    elif args.proxy == "cache":
+        cmd += ["--cache", args.cache]
+    if args.rate:
+        cmd += ["--rate", str(args.rate)]
+    cmd += args.proxy_args.split()
+    os.makedirs(os.path.dirname(PROXY_LOG), exist_ok=True)
+    with open(PROXY_LOG, "w") as log:
+        return subprocess.Popen(cmd, stdout=log, stderr=log)
+
+
+async def wait_listening(port, timeout=15):
+    deadline = time.monotonic() + timeout
+    while True:
+        try:
+            _, w = await asyncio.open_connection("127.0.0.1", port)
+            w.close()
+            return
+        except OSError:
+            if time.monotonic() > deadline:
+                raise ConnectionError(f"proxy is not listening on port {port}")
+            await asyncio.sleep(0.2)
+
+
+async def run_fleet(args, corpus):
+    proxy = start_proxy(args)
+    guests = []
+    try:
+        await wait_listening(args.proxy_port)
+        guests = [Guest(i, args.base_port + i, args) for i in range(args.guests)]
+        await asyncio.gather(*(g.connect(args.proxy_port) for g in guests))
+        print(f"Booting {args.guests} guests...", file=sys.stderr)
+        await asyncio.gather(*(g.wait_line(("READY",)) for g in guests))
+        await asyncio.gather(*(g.wait_line(("CAPS:",)) for g in guests))
+
+        n = args.queries or len(corpus)
+        prompts = [corpus[i % len(corpus)] for i in range(n)]
+        cpu0 = [cpu_seconds(g.qemu.pid) for g in guests]
+        proxy_cpu0 = cpu_seconds(proxy.pid) if proxy else 0.0
+        print(f"Running {n} queries on each guest...", file=sys.stderr)
+        t0 = time.monotonic()
+        await asyncio.gather(*(run_guest(g, prompts, args.think) for g in guests))
+        wall = time.monotonic() - t0
+        cpu = [cpu_seconds(g.qemu.pid) - c for g, c in zip(guests, cpu0)]
+        proxy_cpu = cpu_seconds(proxy.pid) - proxy_cpu0 if proxy else None
+    finally:
+        for g in guests:
+            await g.close()
+        if proxy is not None:
+            proxy.terminate()
+            proxy.wait()
+
+    latency = [x for g in guests for x in g.latency]
+    ttfb = [x for g in guests for x in g.ttfb]
+    return {
+        "wall_s": round(wall, 3),
+        "queries": len(latency),
+        "errors": sum(g.errors for g in guests),
+        "queries_per_sec": round(len(latency) / wall, 3) if wall else None,
+        "latency": percentiles(latency),
+        "ttfb": percentiles(ttfb),
+        "guest_cpu": [{
+            "guest": g.index,
+            "queries": len(g.latency),
+            "cpu_s": round(c, 3),
+            "cpu_pct": round(100 * c / wall, 1) if wall else None,
+        } for g, c in zip(guests, cpu)],
+        "proxy_cpu_s": round(proxy_cpu, 3) if proxy_cpu is not None else None,
+    }
+
+
+def read_corpus(path):
+    with open(path) as f:
+        lines = [line.strip() for line in f]
+    return [line for line in lines if line and not line.startswith("#")]
+
+
+def main():
+    parser = argparse.ArgumentParser(description="PageFault Claude fleet load generator")
+    parser.add_argument("--guests", type=int, default=4, help="Guests to boot (default 4)")
+    parser.add_argument("--queries", type=int,
+                        help="Queries per guest (default: the whole corpus once)")
+    parser.add_argument("--corpus", help="Prompts, one per line (# comments)")
+    parser.add_argument("--think", type=float, default=0.0,
+                        help="Seconds between a guest's queries (default 0)")
+    parser.add_argument("--proxy", choices=["mock", "cache", "api", "external"],
+                        default="mock", help="Proxy to start (default mock)")
+    parser.add_argument("--proxy-port", type=int, default=PROXY_PORT,
+                        help=f"Proxy listen port (default {PROXY_PORT})")
+    parser.add_argument("--proxy-args", default="",
+                        help="Extra claude_proxy.py arguments, e.g. --proxy-args=--no-ack")
+    parser.add_argument("--cache", default=CACHE,
+                        help=f"Response cache for --proxy cache (default {CACHE})")
+    parser.add_argument("--workers", type=int,
+                        help="Proxy API workers (default: one per guest)")
+    parser.add_argument("--rate", type=float, help="Proxy API requests per second")
+    parser.add_argument("--base-port", type=int, default=BASE_PORT,
+                        help=f"Serial port of guest 0; guest i uses base+i (default {BASE_PORT})")
+    parser.add_argument("--smp", type=int, default=SMP, help=f"vCPUs per guest (default {SMP})")
+    parser.add_argument("--accel", choices=["tcg", "kvm"], default="tcg",
+                        help="QEMU accelerator (default tcg)")
+    parser.add_argument("--line", action="store_true",
+                        help="Boot the line-mode REPL (-append line)")
+    parser.add_argument("--output", help="Write JSON here as well as to stdout")
+    args = parser.parse_args()
+
+    if not os.path.exists(KERNEL):
+        print(f"ERROR: {KERNEL} not found. Run 'make' first.", file=sys.stderr)
+        sys.exit(1)
+    if args.accel == "kvm" and not os.access("/dev/kvm", os.R_OK | os.W_OK):
+        print("ERROR: /dev/kvm is not accessible.", file=sys.stderr)
+        sys.exit(1)
+    corpus = read_corpus(args.corpus) if args.corpus else CORPUS
+    if not corpus:
+        print("ERROR: the corpus is empty.", file=sys.stderr)
+        sys.exit(1)
+
+    with open(KERNEL, "rb") as f:
+        kernel_sha = hashlib.sha256(f.read()).hexdigest()
+    qemu_version = subprocess.run(["qemu-system-i386", "--version"],
+                                  capture_output=True, text=True).stdout
+    report = {
+        "kernel_sha256": kernel_sha,
+        "qemu_version": qemu_version.splitlines()[0] if qemu_version else None,
+        "timestamp": int(time.time()),
+        "guests": args.guests,
+        "smp": args.smp,
+        "accel": args.accel,
+        "mode": "line" if args.line else "byte",
+        "proxy": args.proxy,
+        "corpus": len(corpus),
+    }
+
+    try:
+        report["fleet"] = asyncio.run(run_fleet(args, corpus))
+    except (asyncio.TimeoutError, ConnectionError) as e:
+        print(f"FAIL: {e}", file=sys.stderr)
+        sys.exit(1)
+
+    out = json.dumps(report, indent=2)
+    if args.output:
+        with open(args.output, "w") as f:
+            f.write(out + "\n")
+    print(out)
+
+
+if __name__ == "__main__":
+    main()
@@ -14,8 +14,18 @@
  * Wire protocol over serial:
  *   Kernel -> Proxy: "READY\n"           (kernel booted)
  *   Kernel -> Proxy: "Q:<prompt text>\n"  (query for Claude)
- *   Proxy -> Kernel: "A:<response text>\x04"  (answer, terminated by EOT)
+ *   Proxy -> Kernel: "A:<response text>\x04"  (answer, terminated by EOT,
+ *                                             streamed as it is generated)
  *   Kernel -> Proxy: "Claude: <text>\n"  (response echoed for logging)
+ *   Kernel -> Proxy: "STATS:<profile>\n"  (user typed 'stats')
+ *   Kernel -> Proxy: "NEXT:<tag>\n"       (ready for a pipelined answer)
+ *
+ * "READY\n" is followed by "CAPS:frame,ack,pipe\n"; a proxy that answers
+ * with binary frames switches both directions to the framed protocol. A
+ * framed answer that opens with an ack request is not echoed; the kernel
+ * replies "ACK:<length>,<crc>\n" instead and the proxy logs its own copy.
+ * Lines typed while an answer streams are queued and, once the proxy tags
+ * its answers, sent ahead as pipelined queries.
  */
 
 #include <stdint.h>
@@ -50,53 +60,117 @@ enum vga_color {
     VGA_WHITE = 15,
 };
 
-static size_t vga_row;
+/*
+ * The console draws into a shadow ring of VGA_LINES rows in RAM, which
+ * doubles as scrollback. A newline only advances vga_line (and clears
+ * the new row); vga_flush() copies the rows marked in vga_dirty to VGA
+ * memory. Callers flush at natural boundaries (a status message, a
+ * received chunk, before waiting for input), so one flush absorbs many
+ * characters and scrolls instead of one MMIO store per cell each time.
+ */
+#define VGA_LINES       256     /* Shadow ring + scrollback, power of two */
+#define VGA_ALL_DIRTY   ((1u << VGA_HEIGHT) - 1)
+#define VGA_ROW(line)   vga_buf[(line) & (VGA_LINES - 1)]
+
+static uint16_t vga_buf[VGA_LINES][VGA_WIDTH] __attribute__((aligned(4)));
+static uint32_t vga_line;       /* Absolute line number of the cursor row */
 static size_t vga_col;
+static uint32_t vga_back;       /* Lines scrolled back from the bottom */
+static uint32_t vga_dirty;      /* Screen rows to copy on the next flush */
 static uint8_t vga_color;
 
+/* Absolute line number shown on screen row 0 */
+static uint32_t vga_top(void) {
+    uint32_t top = vga_line >= VGA_HEIGHT ? vga_line - (VGA_HEIGHT - 1) : 0;
+    return top - vga_back;
+}
+
+static void vga_clear_row(uint32_t line) {
+    for (size_t x = 0; x < VGA_WIDTH; x++)
+        VGA_ROW(line)[x] = VGA_ENTRY(' ', vga_color);
+}
+
+/* Copy dirty rows to VGA memory, two cells per 32-bit store */
+static void vga_flush(void) {
+    if (!vga_dirty) return;
+    uint32_t top = vga_top();
+    for (size_t y = 0; y < VGA_HEIGHT; y++) {
+        if (!(vga_dirty & (1u << y))) continue;
+        const uint16_t *src = VGA_ROW(top + y);
+        volatile uint16_t *dst = VGA_MEMORY + y * VGA_WIDTH;
+        uint32_t n = VGA_WIDTH / 2;
+        __asm__ volatile ("rep movsl"
+                          : "+S"(src), "+D"(dst), "+c"(n) : : "memory");
+    }
+    vga_dirty = 0;
+}
+
 static void vga_init(void) {
-    vga_row = 0;
+    vga_line = 0;
     vga_col = 0;
+    vga_back = 0;
     vga_color = VGA_COLOR(VGA_LIGHT_GREEN, VGA_BLACK);
 
-    for (size_t y = 0; y < VGA_HEIGHT; y++)
-        for (size_t x = 0; x < VGA_WIDTH; x++)
-            VGA_MEMORY[y * VGA_WIDTH + x] = VGA_ENTRY(' ', vga_color);
+    for (uint32_t y = 0; y < VGA_LINES; y++)
+        vga_clear_row(y);
+    vga_dirty = VGA_ALL_DIRTY;
+    vga_flush();
 }
 
-static void vga_scroll(void) {
-    for (size_t y = 0; y < VGA_HEIGHT - 1; y++)
-        for (size_t x = 0; x < VGA_WIDTH; x++)
-            VGA_MEMORY[y * VGA_WIDTH + x] = VGA_MEMORY[(y + 1) * VGA_WIDTH + x];
-    for (size_t x = 0; x < VGA_WIDTH; x++)
-        VGA_MEMORY[(VGA_HEIGHT - 1) * VGA_WIDTH + x] = VGA_ENTRY(' ', vga_color);
-    vga_row = VGA_HEIGHT - 1;
+/* Scroll the view back (lines > 0) or forward through the scrollback */
+static void vga_scrollback(int lines) {
+    uint32_t bottom = vga_line >= VGA_HEIGHT ? vga_line - (VGA_HEIGHT - 1) : 0;
+    uint32_t oldest = vga_line >= VGA_LINES ? vga_line - (VGA_LINES - 1) : 0;
+    int back = (int)vga_back + lines;
+
+    if (back > (int)(bottom - oldest)) back = (int)(bottom - oldest);
+    if (back < 0) back = 0;
+    if ((uint32_t)back != vga_back) {
+        vga_back = (uint32_t)back;
+        vga_dirty = VGA_ALL_DIRTY;
+    }
+}
+
+static void vga_newline(void) {
+    vga_col = 0;
+    vga_line++;
+    vga_clear_row(vga_line);
+    if (vga_line >= VGA_HEIGHT)
+        vga_dirty = VGA_ALL_DIRTY;      /* Whole screen moved up a row */
+    else
+        vga_dirty |= 1u << vga_line;
 }
 
 static void vga_putchar(char c) {
+    /* New output snaps a scrolled-back view to the bottom */
+    if (vga_back) {
+        vga_back = 0;
+        vga_dirty = VGA_ALL_DIRTY;
+    }
+
     if (c == '\n') {
-        vga_col = 0;
-        if (++vga_row >= VGA_HEIGHT) vga_scroll();
+        vga_newline();
         return;
     }
     if (c == '\r') { vga_col = 0; return; }
     if (c == '\b') {
         if (vga_col > 0) {
             vga_col--;
-            VGA_MEMORY[vga_row * VGA_WIDTH + vga_col] = VGA_ENTRY(' ', vga_color);
+            VGA_ROW(vga_line)[vga_col] = VGA_ENTRY(' ', vga_color);
+            vga_dirty |= 1u << (vga_line - vga_top());
         }
         return;
     }
 
-    VGA_MEMORY[vga_row * VGA_WIDTH + vga_col] = VGA_ENTRY(c, vga_color);
-    if (++vga_col >= VGA_WIDTH) {
-        vga_col = 0;
-        if (++vga_row >= VGA_HEIGHT) vga_scroll();
-    }
+    VGA_ROW(vga_line)[vga_col] = VGA_ENTRY(c, vga_color);
+    vga_dirty |= 1u << (vga_line - vga_top());
+    if (++vga_col >= VGA_WIDTH)
+        vga_newline();
 }
 
 static void vga_puts(const char *s) {
     while (*s) vga_putchar(*s++);
+    vga_flush();
 }
 
 static void vga_set_color(uint8_t fg, uint8_t bg) {
@@ -115,10 +189,30 @@ static inline uint8_t inb(uint16_t port) {
     return ret;
 }
 
+static inline void outl(uint16_t port, uint32_t val) {
+    __asm__ volatile ("outl %0, %1" : : "a"(val), "Nd"(port));
+}
+
+static inline uint32_t inl(uint16_t port) {
+    uint32_t ret;
+    __asm__ volatile ("inl %1, %0" : "=a"(ret) : "Nd"(port));
+    return ret;
+}
+
 /* ========== Serial Port (COM1) ========== */
 
 #define COM1 0x3F8
 
+/*
+ * Received bytes are moved from the UART into rx_ring by the IRQ4
+ * handler (single producer); serial_read() is the single consumer.
+ */
+#define SERIAL_RX_SIZE  4096     /* Power of two */
+
+static volatile uint8_t rx_ring[SERIAL_RX_SIZE];
+static volatile uint32_t rx_head;   /* Written by serial_irq() */
+static volatile uint32_t rx_tail;   /* Written by serial_read() */
+
 static void serial_init(void) {
     outb(COM1 + 1, 0x00);    /* Disable all interrupts */
     outb(COM1 + 3, 0x80);    /* Enable DLAB */
@@ -127,29 +221,401 @@ static void serial_init(void) {
     outb(COM1 + 3, 0x03);    /* 8N1 */
     outb(COM1 + 2, 0xC7);    /* Enable FIFO */
     outb(COM1 + 4, 0x0B);    /* IRQs enabled, RTS/DSR set */
+    outb(COM1 + 1, 0x01);    /* Interrupt on received data */
+}
+
+/* Move everything in the UART FIFO into the ring (drops bytes when full) */
+static void serial_drain(void) {
+    while (inb(COM1 + 5) & 0x01) {
+        uint8_t c = inb(COM1);
+        if (rx_head - rx_tail < SERIAL_RX_SIZE) {
+            rx_ring[rx_head & (SERIAL_RX_SIZE - 1)] = c;
+            rx_head++;
+        }
+    }
+}
+
+/* IRQ4: COM1 received data */
+void serial_irq(void);
+void serial_irq(void) {
+    serial_drain();
+    outb(0x20, 0x20);        /* EOI to master PIC */
 }
 
 static int serial_received(void) {
-    return inb(COM1 + 5) & 0x01;
+    return rx_head != rx_tail;
 }
 
 static char serial_read(void) {
-    while (!serial_received()) ;
-    return inb(COM1);
+    while (1) {
+        __asm__ volatile ("cli");
+        if (serial_received()) break;
+        __asm__ volatile ("sti; hlt");  /* sti shadow: no lost wakeup */
+    }
+    __asm__ volatile ("sti");
+    char c = rx_ring[rx_tail & (SERIAL_RX_SIZE - 1)];
+    rx_tail++;
+    return c;
 }
 
+#define SERIAL_TX_FIFO  16       /* 16550A transmit FIFO depth */
+
 static void serial_write(char c) {
     while (!(inb(COM1 + 5) & 0x20)) ;
     outb(COM1, c);
 }
 
+/* THRE means the whole transmit FIFO is empty: refill it in one burst */
+static void serial_write_bytes(const char *src, size_t n) {
+    while (n) {
+        while (!(inb(COM1 + 5) & 0x20)) ;
+        size_t burst = n < SERIAL_TX_FIFO ? n : SERIAL_TX_FIFO;
+        for (size_t i = 0; i < burst; i++)
+            outb(COM1, src[i]);
+        src += burst;
+        n -= burst;
+    }
+}
+
 static void serial_puts(const char *s) {
-    while (*s) serial_write(*s++);
+    size_t n = 0;
+    while (s[n]) n++;
+    serial_write_bytes(s, n);
+}
+
+/* 64-by-32 long division (no libgcc in a freestanding -m32 build) */
+static uint64_t udiv64(uint64_t n, uint32_t d, uint32_t *rem) {
+    uint64_t q = 0, r = 0;
+    for (int i = 63; i >= 0; i--) {
+        r = (r << 1) | ((n >> i) & 1);
+        if (r >= d) {
+            r -= d;
+            q |= 1ULL << i;
+        }
+    }
+    if (rem) *rem = (uint32_t)r;
+    return q;
+}
+
+/* Write v in decimal through `put` (serial_write or wire_write) */
+static void put_dec(void (*put)(char), uint64_t v) {
+    char buf[20];
+    int n = 0;
+    do {
+        uint32_t digit;
+        v = udiv64(v, 10, &digit);
+        buf[n++] = '0' + digit;
+    } while (v);
+    while (n) put(buf[--n]);
+}
+
+/* Read exactly n bytes, copying straight out of the receive ring */
+static void serial_read_bytes(char *dst, size_t n) {
+    while (n) {
+        if (!serial_received()) {
+            *dst++ = serial_read();     /* Sleeps until data arrives */
+            n--;
+            continue;
+        }
+        uint32_t avail = rx_head - rx_tail;
+        uint32_t off = rx_tail & (SERIAL_RX_SIZE - 1);
+        uint32_t run = SERIAL_RX_SIZE - off;     /* Up to the ring's end */
+        if (run > avail) run = avail;
+        if (run > n) run = n;
+        for (uint32_t i = 0; i < run; i++)
+            dst[i] = rx_ring[off + i];
+        rx_tail += run;
+        dst += run;
+        n -= run;
+    }
+}
+
+/* ========== PCI Configuration Space ========== */
+
+#define PCI_CONFIG_ADDR 0xCF8
+#define PCI_CONFIG_DATA 0xCFC
+
+static uint32_t pci_read(int dev, int off) {
+    outl(PCI_CONFIG_ADDR, 0x80000000u | ((uint32_t)dev << 11) | (off & 0xfc));
+    return inl(PCI_CONFIG_DATA);
+}
+
+static void pci_write(int dev, int off, uint32_t val) {
+    outl(PCI_CONFIG_ADDR, 0x80000000u | ((uint32_t)dev << 11) | (off & 0xfc));
+    outl(PCI_CONFIG_DATA, val);
+}
+
+/* Find device `vendor:device` on bus 0; returns the slot number or -1 */
+static int pci_find(uint16_t vendor, uint16_t device) {
+    for (int dev = 0; dev < 32; dev++) {
+        if (pci_read(dev, 0) == ((uint32_t)device << 16 | vendor))
+            return dev;
+    }
+    return -1;
+}
+
+/* ========== Shared-Memory Ring (ivshmem) ========== */
+
+/*
+ * With a QEMU ivshmem-plain device present, protocol traffic moves
+ * through two single-producer/single-consumer byte rings in its shared
+ * memory (BAR2), which the host proxy maps from the same backing file:
+ *
+ *   0x0000  struct shm_header (magic, version, ring size, ring indices)
+ *   0x1000  tx data: kernel -> host
+ *   0x1000 + SHM_RING_SIZE  rx data: host -> kernel
+ *
+ * Indices are free-running; each side only writes its own (producer
+ * head, consumer tail), on separate cache lines. Data is written before
+ * the head is published. x86 keeps stores in order, so a compiler
+ * barrier is all the kernel needs. There is no doorbell; the reader polls.
+ */
+#define IVSHMEM_VENDOR  0x1af4
+#define IVSHMEM_DEVICE  0x1110
+#define SHM_MAGIC       0x53434650      /* "PFCS" */
+#define SHM_VERSION     1
+#define SHM_RING_SIZE   0x10000         /* Power of two */
+#define SHM_DATA_OFF    0x1000
+#define SHM_MIN_SIZE    (SHM_DATA_OFF + 2 * SHM_RING_SIZE)
+
+struct shm_ring {
+    volatile uint32_t head;             /* Producer index */
+    uint32_t pad0[15];
+    volatile uint32_t tail;             /* Consumer index */
+    uint32_t pad1[15];
+};
+
+struct shm_header {
+    volatile uint32_t magic;            /* Written last, once rings are reset */
+    uint32_t version;
+    uint32_t ring_size;
+    uint32_t pad[13];
+    struct shm_ring tx;                 /* Kernel -> host */
+    struct shm_ring rx;                 /* Host -> kernel */
+};
+
+static struct shm_header *shm;
+static volatile uint8_t *shm_tx_data;
+static volatile uint8_t *shm_rx_data;
+
+#define barrier() __asm__ volatile ("" : : : "memory")
+
+/* Locate and map the ivshmem BAR and reset both rings. Returns 0 on success. */
+static int shm_init(void) {
+    int dev = pci_find(IVSHMEM_VENDOR, IVSHMEM_DEVICE);
+    if (dev < 0) return -1;
+
+    /* BAR2 is a 64-bit memory BAR; it must sit below 4GB to be reachable */
+    uint32_t bar = pci_read(dev, 0x18);
+    if ((bar & 0x6) == 0x4 && pci_read(dev, 0x1c) != 0) return -1;
+    pci_write(dev, 0x18, 0xffffffff);
+    uint32_t size = ~(pci_read(dev, 0x18) & ~0xfu) + 1;
+    pci_write(dev, 0x18, bar);
+    bar &= ~0xfu;
+    if (bar == 0 || size < SHM_MIN_SIZE) return -1;
+
+    pci_write(dev, 0x04, pci_read(dev, 0x04) | 0x2);   /* Memory space on */
+    wm_map_mmio(bar, size);
+
+    shm = (struct shm_header *)bar;
+    shm_tx_data = (volatile uint8_t *)(bar + SHM_DATA_OFF);
+    shm_rx_data = shm_tx_data + SHM_RING_SIZE;
+
+    shm->magic = 0;
+    barrier();
+    shm->tx.head = shm->tx.tail = 0;
+    shm->rx.head = shm->rx.tail = 0;
+    shm->version = SHM_VERSION;
+    shm->ring_size = SHM_RING_SIZE;
+    barrier();
+    shm->magic = SHM_MAGIC;
+    return 0;
+}
+
+static void shm_read_bytes(char *dst, size_t n) {
+    while (n) {
+        uint32_t tail = shm->rx.tail;
+        uint32_t avail = shm->rx.head - tail;
+        if (!avail) {
+            __asm__ volatile ("pause");
+            continue;
+        }
+        barrier();
+        uint32_t off = tail & (SHM_RING_SIZE - 1);
+        uint32_t run = SHM_RING_SIZE - off;
+        if (run > avail) run = avail;
+        if (run > n) run = n;
+        for (uint32_t i = 0; i < run; i++)
+            dst[i] = shm_rx_data[off + i];
+        barrier();
+        shm->rx.tail = tail + run;
+        dst += run;
+        n -= run;
+    }
+}
+
+static int shm_pending(void) {
+    return shm->rx.head != shm->rx.tail;
+}
+
+static char shm_read(void) {
+    char c;
+    shm_read_bytes(&c, 1);
+    return c;
+}
+
+static void shm_write_bytes(const char *src, size_t n) {
+    while (n) {
+        uint32_t head = shm->tx.head;
+        uint32_t space = SHM_RING_SIZE - (head - shm->tx.tail);
+        if (!space) {
+            __asm__ volatile ("pause");
+            continue;
+        }
+        uint32_t off = head & (SHM_RING_SIZE - 1);
+        uint32_t run = SHM_RING_SIZE - off;
+        if (run > space) run = space;
+        if (run > n) run = n;
+        for (uint32_t i = 0; i < run; i++)
+            shm_tx_data[off + i] = src[i];
+        barrier();
+        shm->tx.head = head + run;
+        src += run;
+        n -= run;
+    }
+}
+
+/* ========== Transport ========== */
+
+/*
+ * The wire carries everything the proxy parses (READY, CAPS, Q:, A:,
+ * STATS, BYE and frames). Keystroke and response echoes are logging and
+ * always go to the UART. Without a shared-memory device the wire is the
+ * UART itself, exactly as before.
+ */
+struct transport {
+    const char *name;
+    int  (*pending)(void);                      /* Bytes ready to read? */
+    char (*read)(void);                         /* Blocks */
+    void (*read_bytes)(char *dst, size_t n);    /* Blocks for all n */
+    void (*write_bytes)(const char *src, size_t n);
+};
+
+static const struct transport uart_transport = {
+    "uart", serial_received, serial_read, serial_read_bytes, serial_write_bytes,
+};
+
+static const struct transport shm_transport = {
+    "shm", shm_pending, shm_read, shm_read_bytes, shm_write_bytes,
+};
+
+static const struct transport *wire = &uart_transport;
+
+static char wire_read(void) {
+    return wire->read();
+}
+
+static void wire_write(char c) {
+    wire->write_bytes(&c, 1);
+}
+
+static void wire_puts(const char *s) {
+    size_t n = 0;
+    while (s[n]) n++;
+    wire->write_bytes(s, n);
+}
+
+/* Switch the wire to the shared-memory ring if the device is present */
+static void transport_init(void) {
+    if (shm_init() == 0)
+        wire = &shm_transport;
+}
+
+/* ========== Framed Protocol ========== */
+
+/*
+ * Binary frames: SOH, type, length (16-bit LE), CRC-16/CCITT (LE) over
+ * type, length and payload, then the payload.
+ *
+ *   Kernel -> Proxy: FRAME_QUERY     prompt text
+ *   Proxy -> Kernel: FRAME_CHUNK     part of an answer (any number)
+ *   Proxy -> Kernel: FRAME_ANSWER    last part of an answer
+ *   Proxy -> Kernel: FRAME_ACKREQ    (empty, before the first chunk) keeps
+ *                                    its own copy of the answer
+ *   Kernel -> Proxy: FRAME_PIPE      tag byte, prompt text: a query typed
+ *                                    ahead while an answer is streaming
+ *   Proxy -> Kernel: FRAME_PIPE      tag byte (before the first chunk): the
+ *                                    query answered, 0 for FRAME_QUERY
+ *
+ * The kernel advertises support with "CAPS:frame,ack,pipe\n" after READY
+ * but keeps speaking text until the proxy answers with a frame; from then
+ * on queries are framed too. A proxy that never frames stays in text mode.
+ * Pipelined queries are only sent once the proxy has tagged an answer,
+ * and their answers come back in the order they were sent.
+ */
+
+#define FRAME_SOH       0x01
+#define FRAME_QUERY     'Q'
+#define FRAME_CHUNK     'a'
+#define FRAME_ANSWER    'A'
+#define FRAME_ACKREQ    'k'
+#define FRAME_PIPE      'P'
+#define FRAME_MAX       1024
+#define FRAME_HDR       5       /* Header bytes after SOH */
+
+static int proxy_framed;        /* Proxy has sent us a frame */
+static int proxy_pipe;          /* Proxy has tagged an answer */
+static char frame_buf[FRAME_MAX];
+
+static uint16_t crc16_update(uint16_t crc, const char *p, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        crc ^= (uint16_t)(uint8_t)p[i] << 8;
+        for (int b = 0; b < 8; b++)
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+    }
+    return crc;
+}
+
+static void frame_send(char type, const char *payload, size_t len) {
+    char hdr[3] = { type, (char)(len & 0xff), (char)(len >> 8) };
+    uint16_t crc = crc16_update(0xffff, hdr, 3);
+    crc = crc16_update(crc, payload, len);
+
+    char head[FRAME_HDR + 1] = {
+        FRAME_SOH, hdr[0], hdr[1], hdr[2], (char)(crc & 0xff), (char)(crc >> 8),
+    };
+    wire->write_bytes(head, sizeof(head));
+    wire->write_bytes(payload, len);
+}
+
+/*
+ * Receive one frame (SOH already consumed) into frame_buf.
+ * Returns the payload length, or -1 if the frame is oversized or its
+ * CRC does not match (the payload is then skipped as well as possible).
+ */
+static int frame_recv(char *type) {
+    char hdr[FRAME_HDR];
+    wire->read_bytes(hdr, FRAME_HDR);
+    *type = hdr[0];
+    size_t len = (uint8_t)hdr[1] | ((size_t)(uint8_t)hdr[2] << 8);
+    uint16_t want = (uint8_t)hdr[3] | ((uint16_t)(uint8_t)hdr[4] << 8);
+
+    if (len > FRAME_MAX) {
+        for (size_t i = 0; i < len; i++) wire_read();
+        return -1;
+    }
+    wire->read_bytes(frame_buf, len);
+
+    uint16_t crc = crc16_update(0xffff, hdr, 3);
+    crc = crc16_update(crc, frame_buf, len);
+    return crc == want ? (int)len : -1;
 }
 
 /* ========== PS/2 Keyboard (Scan Code Set 1) ========== */
 
 #define KBD_DATA_PORT   0x60
+#define KBD_SC_PGUP     0x49    /* After the 0xE0 prefix (or keypad 9) */
+#define KBD_SC_PGDN     0x51    /* After the 0xE0 prefix (or keypad 3) */
 #define KBD_STATUS_PORT 0x64
 
 static int kbd_shift;
@@ -189,39 +655,332 @@ static int kbd_has_key(void) {
     return inb(KBD_STATUS_PORT) & 0x01;
 }
 
+/* IRQ1: only wakes up the hlt in input_read(); the scancode is left in
+ * the controller for input_read() to pick up */
+void kbd_irq(void);
+void kbd_irq(void) {
+    outb(0x20, 0x20);        /* EOI to master PIC */
+}
+
 /*
- * Poll both PS/2 keyboard and serial; return the first available ASCII char.
+ * Decode one pending scancode: returns its ASCII char, or 0 for a key
+ * with none (shift, release, Page Up/Down, ...) or if none is pending.
+ */
+static char kbd_getc(void) {
+    if (!kbd_has_key()) return 0;
+    uint8_t sc = inb(KBD_DATA_PORT);
+
+    /* Track shift key state */
+    if (sc == 0x2A || sc == 0x36) { kbd_shift = 1; return 0; }
+    if (sc == 0xAA || sc == 0xB6) { kbd_shift = 0; return 0; }
+
+    /* Ignore key-release (break) codes */
+    if (sc & 0x80) return 0;
+
+    /* Page Up / Page Down browse the scrollback */
+    if (sc == KBD_SC_PGUP) { vga_scrollback(VGA_HEIGHT - 1); return 0; }
+    if (sc == KBD_SC_PGDN) { vga_scrollback(-(VGA_HEIGHT - 1)); return 0; }
+
+    /* Ignore scancodes beyond our table */
+    if (sc >= 58) return 0;
+
+    return kbd_shift ? sc_shifted[sc] : sc_unshifted[sc];
+}
+
+/*
+ * Keystrokes typed while an answer streams are queued here by
+ * typeahead_poll() and replayed by input_read() before anything new, so
+ * the next lines can be typed (and, see typeahead_pipe(), sent) early.
+ * ta_scan is the start of the first line typeahead_pipe() has not looked
+ * at; it only ever points at a line boundary, never before ta_tail.
+ */
+#define TYPEAHEAD_SIZE  1024     /* Power of two */
+
+static char typeahead[TYPEAHEAD_SIZE];
+static uint32_t ta_head, ta_tail, ta_scan;
+
+static void typeahead_poll(void) {
+    while (kbd_has_key()) {
+        char c = kbd_getc();
+        if (c && ta_head - ta_tail < TYPEAHEAD_SIZE)
+            typeahead[ta_head++ & (TYPEAHEAD_SIZE - 1)] = c;
+    }
+}
+
+/*
+ * Return the next input char: queued typeahead first, then whichever of
+ * the PS/2 keyboard and serial has data.
  * Keyboard input lets the user type in the QEMU window.
  * Serial fallback keeps automated tests (run_test.py) working.
  */
 static char input_read(void) {
-    while (1) {
-        /* Check PS/2 keyboard */
-        if (kbd_has_key()) {
-            uint8_t sc = inb(KBD_DATA_PORT);
-
-            /* Track shift key state */
-            if (sc == 0x2A || sc == 0x36) { kbd_shift = 1; continue; }
-            if (sc == 0xAA || sc == 0xB6) { kbd_shift = 0; continue; }
+    if (ta_tail != ta_head) {
+        char c = typeahead[ta_tail++ & (TYPEAHEAD_SIZE - 1)];
+        if (c == '\n' && (int32_t)(ta_tail - ta_scan) > 0)
+            ta_scan = ta_tail;          /* Line replayed without being piped */
+        return c;
+    }
 
-            /* Ignore key-release (break) codes */
-            if (sc & 0x80) continue;
+    /* The queue is empty: a line it left unfinished is finished live,
+     * so what is typed ahead next starts a new line */
+    ta_scan = ta_head;
 
-            /* Ignore scancodes beyond our table */
-            if (sc >= 58) continue;
+    while (1) {
+        /* Show everything drawn so far before waiting */
+        vga_flush();
+
+        /* Sleep until the keyboard or UART interrupts */
+        __asm__ volatile ("cli");
+        if (!kbd_has_key() && !serial_received()) {
+            __asm__ volatile ("sti; hlt");
+            continue;
+        }
+        __asm__ volatile ("sti");
 
-            char c = kbd_shift ? sc_shifted[sc] : sc_unshifted[sc];
+        /* Check PS/2 keyboard */
+        if (kbd_has_key()) {
+            char c = kbd_getc();
             if (c) return c;
             continue;  /* non-printable key, keep polling */
         }
 
         /* Check serial (fallback for automated tests) */
         if (serial_received()) {
-            return inb(COM1);
+            return serial_read();
         }
     }
 }
 
+/* ========== Interrupts ========== */
+
+/*
+ * Normal-mode IDT, used only while the kernel runs between cascades.
+ * wm_launch()/wm_resume() swap the weird machine's IDT in and out.
+ * The 8259 PICs are remapped to vectors 0x20-0x2F with all lines masked
+ * except IRQ1 (keyboard) and IRQ4 (COM1).
+ */
+#define IRQ_BASE        0x20
+#define IRQ_KBD         1
+#define IRQ_COM1        4
+#define IRQ_PIC7        7       /* Spurious master PIC interrupt */
+#define IRQ_PIC15       15      /* Spurious slave PIC interrupt */
+#define NUM_EXCEPTIONS  32
+
+#define IRQ_WAKE        0xF0    /* Local APIC: wake an idle AP */
+#define IRQ_SPURIOUS    0xFF    /* Local APIC spurious vector */
+
+extern void irq_com1_stub(void);
+extern void irq_kbd_stub(void);
+extern void irq_wake_stub(void);
+extern void irq_spurious_stub(void);
+extern void irq_pic7_stub(void);
+extern void irq_pic15_stub(void);
+extern void (*const exception_stubs[NUM_EXCEPTIONS])(void);
+
+static void boot_fail(const char *why) __attribute__((noreturn));
+
+/* Append "<label>0x<v in hex>" at p */
+static char *fmt_hex(char *p, const char *label, uint32_t v) {
+    while (*label) *p++ = *label++;
+    *p++ = '0';
+    *p++ = 'x';
+    for (int shift = 28; shift >= 0; shift -= 4)
+        *p++ = "0123456789abcdef"[(v >> shift) & 0xf];
+    return p;
+}
+
+/* A CPU exception outside a cascade (isr.S): report it and stop, rather
+ * than the triple fault an empty gate would end in */
+void exception_report(uint32_t vec, uint32_t err, uint32_t eip);
+void exception_report(uint32_t vec, uint32_t err, uint32_t eip) {
+    char msg[64];
+    char *p = fmt_hex(msg, "CPU exception ", vec);
+    p = fmt_hex(p, " err=", err);
+    p = fmt_hex(p, " eip=", eip);
+    *p = 0;
+    boot_fail(msg);
+}
+
+static uint32_t host_idt[256 * 2] __attribute__((aligned(8)));
+
+/* 32-bit interrupt gate, ring 0, code selector 0x08 */
+static void idt_set_gate(int vec, void (*handler)(void)) {
+    uint32_t off = (uint32_t)handler;
+    host_idt[vec * 2]     = (0x08 << 16) | (off & 0xffff);
+    host_idt[vec * 2 + 1] = (off & 0xffff0000) | 0x8e00;
+}
+
+static void pic_init(void) {
+    outb(0x20, 0x11);   outb(0xA0, 0x11);       /* ICW1: init, ICW4 follows */
+    outb(0x21, IRQ_BASE); outb(0xA1, IRQ_BASE + 8); /* ICW2: vector base */
+    outb(0x21, 0x04);   outb(0xA1, 0x02);       /* ICW3: cascade on IRQ2 */
+    outb(0x21, 0x01);   outb(0xA1, 0x01);       /* ICW4: 8086 mode */
+    outb(0x21, (uint8_t)~((1 << IRQ_KBD) | (1 << IRQ_COM1)));
+    outb(0xA1, 0xff);
+}
+
+/* Load the host IDT on the calling CPU and hand it to its instance */
+static void host_idt_load(void) {
+    struct __attribute__((__packed__)) {
+        uint16_t limit;
+        uint32_t base;
+    } idtr = { sizeof(host_idt) - 1, (uint32_t)host_idt };
+    __asm__ volatile ("lidtl %0" : : "m"(idtr) : "memory");
+
+    wm_set_host_idt(idtr.base, idtr.limit);
+}
+
+static void interrupts_init(void) {
+    for (int vec = 0; vec < NUM_EXCEPTIONS; vec++)
+        idt_set_gate(vec, exception_stubs[vec]);
+    idt_set_gate(IRQ_BASE + IRQ_PIC7, irq_pic7_stub);
+    idt_set_gate(IRQ_BASE + IRQ_PIC15, irq_pic15_stub);
+    idt_set_gate(IRQ_BASE + IRQ_KBD, irq_kbd_stub);
+    idt_set_gate(IRQ_BASE + IRQ_COM1, irq_com1_stub);
+    idt_set_gate(IRQ_WAKE, irq_wake_stub);
+    idt_set_gate(IRQ_SPURIOUS, irq_spurious_stub);
+    pic_init();
+    host_idt_load();
+
+    /* The PIC is edge-triggered: empty the FIFO so the UART drops its
+     * interrupt line and the next byte raises a fresh edge */
+    serial_drain();
+    __asm__ volatile ("sti");
+}
+
+/*
+ * ========== Multiprocessor ==========
+ *
+ * The application processors are started with INIT-SIPI-SIPI through
+ * kernel/ap_boot.S. Each sets itself up as its own weird machine
+ * instance (wm_setup_cpu()) and idles in hlt until smp_post() hands it
+ * a function, which then builds and runs movdbz programs on that CPU's
+ * instance in parallel with the boot CPU. Sessions stay on the boot
+ * CPU, which owns the wire, keyboard and display. Only the xAPIC is
+ * used; no ACPI/MP table parsing, so CPUs are counted as they check in.
+ */
+
+#define LAPIC_BASE      0xFEE00000
+#define LAPIC_ID        0x020
+#define LAPIC_EOI       0x0B0
+#define LAPIC_SVR       0x0F0
+#define LAPIC_ICR_LO    0x300
+#define LAPIC_ICR_HI    0x310
+
+#define ICR_PENDING     0x01000
+#define ICR_INIT        0xC4500     /* All excluding self, assert, INIT */
+#define ICR_STARTUP     0xC4600     /* All excluding self, assert, SIPI */
+#define ICR_FIXED       0x04000     /* Destination field, assert, fixed */
+
+#define AP_BOOT_ADDR    0x7000      /* Copy of ap_boot.S, SIPI vector 0x07 */
+#define AP_STACK_SIZE   16384
+
+extern char ap_boot_start[], ap_boot_end[];
+
+/* Read by ap_boot.S */
+volatile uint32_t ap_next = 1;
+uint32_t ap_max = WM_MAX_CPUS;
+uint32_t ap_stack_top[WM_MAX_CPUS];
+
+static uint8_t ap_stacks[WM_MAX_CPUS][AP_STACK_SIZE] __attribute__((aligned(16)));
+static volatile uint32_t ap_online;             /* APs that checked in */
+static volatile uint8_t ap_apic_id[WM_MAX_CPUS];
+static void (*volatile ap_work[WM_MAX_CPUS])(void);
+static int num_cpus = 1;
+
+static inline uint32_t lapic_read(uint32_t reg) {
+    return *(volatile uint32_t *)(LAPIC_BASE + reg);
+}
+
+static inline void lapic_write(uint32_t reg, uint32_t val) {
+    *(volatile uint32_t *)(LAPIC_BASE + reg) = val;
+}
+
+void lapic_eoi(void);
+void lapic_eoi(void) {
+    lapic_write(LAPIC_EOI, 0);
+}
+
+static void lapic_ipi(uint32_t dest, uint32_t icr) {
+    lapic_write(LAPIC_ICR_HI, dest << 24);
+    lapic_write(LAPIC_ICR_LO, icr);
+    while (lapic_read(LAPIC_ICR_LO) & ICR_PENDING)
+        __asm__ volatile ("pause");
+}
+
+/* Roughly a microsecond per port 0x80 write */
+static void io_delay(uint32_t us) {
+    while (us--)
+        outb(0x80, 0);
+}
+
+void ap_entry(int cpu);
+void ap_entry(int cpu) {
+    wm_setup_cpu(cpu);
+    host_idt_load();
+    lapic_write(LAPIC_SVR, 0x100 | IRQ_SPURIOUS);  /* Software-enable */
+    ap_apic_id[cpu] = (uint8_t)(lapic_read(LAPIC_ID) >> 24);
+    __asm__ volatile ("lock incl %0" : "+m"(ap_online) : : "memory");
+
+    for (;;) {
+        /* Checked with interrupts off: a wake IPI arriving in between
+         * stays pending and ends the hlt */
+        __asm__ volatile ("cli" : : : "memory");
+        void (*fn)(void) = ap_work[cpu];
+        if (!fn) {
+            __asm__ volatile ("sti; hlt" : : : "memory");
+            continue;
+        }
+        __asm__ volatile ("sti");
+        fn();
+        barrier();
+        ap_work[cpu] = 0;
+    }
+}
+
+/* Run fn on an idle AP's instance */
+static void smp_post(int cpu, void (*fn)(void)) {
+    ap_work[cpu] = fn;
+    lapic_ipi(ap_apic_id[cpu], ICR_FIXED | IRQ_WAKE);
+}
+
+static void smp_wait(int cpu) {
+    while (ap_work[cpu])
+        __asm__ volatile ("pause");
+}
+
+static void smp_init(void) {
+    wm_map_mmio(LAPIC_BASE, 0x1000);
+    lapic_write(LAPIC_SVR, 0x100 | IRQ_SPURIOUS);
+
+    const char *src = ap_boot_start;
+    char *dst = (char *)AP_BOOT_ADDR;
+    while (src < ap_boot_end)
+        *dst++ = *src++;
+    for (int i = 0; i < WM_MAX_CPUS; i++)
+        ap_stack_top[i] = (uint32_t)ap_stacks[i] + AP_STACK_SIZE;
+
+    lapic_ipi(0, ICR_INIT);
+    io_delay(10000);
+    for (int k = 0; k < 2; k++) {
+        lapic_ipi(0, ICR_STARTUP | (AP_BOOT_ADDR >> 12));
+        io_delay(200);
+    }
+
+    /* Wait for check-ins until none arrive for 10ms (at most 100ms) */
+    uint32_t seen = 0, quiet = 0;
+    for (int ms = 0; ms < 100 && quiet < 10; ms++) {
+        io_delay(1000);
+        if (ap_online != seen) {
+            seen = ap_online;
+            quiet = 0;
+        } else if (seen) {
+            quiet++;
+        }
+    }
+    num_cpus = 1 + (int)ap_online;
+}
+
 /* ========== I/O Bridge Buffer ========== */
 
 #define PROMPT_BUF_SIZE 1024
@@ -243,101 +1002,309 @@ static int streq(const char *a, const char *b, size_t n) {
  * The REPL state machine runs inside the page fault weird machine.
  * It uses I/O bridge "exits" to communicate with the outside world.
  *
- * Register allocation:
- *   r0 = cmd    (I/O command: 0=exit, 1=read_byte, 2=write_byte, 3=send_query, 4=recv_response)
- *   r1 = data   (byte value for read/write)
- *   r2 = state  (internal state for quit detection)
- *   r3 = temp
+ * The program is written in kernel/repl.wm and compiled at build time by
+ * tools/wmc.py into build/repl_prog.h (the header lists the optimized
+ * movdbz code). Each phase sets r_cmd and exits; the bridge performs the
+ * I/O and resumes at the next phase's entry label:
  *
- * The movdbz REPL program:
- *
- *   -- PHASE 1: Signal "read a line" to bridge --
- *   L0:  movdbz r0, CMD_READ_BYTE, L1, L1   ; r0 = READ_BYTE (1)
- *   L1:  movdbz _, _, EXIT, EXIT             ; exit to bridge (read byte)
- *
- *   -- PHASE 1b: Bridge resumes here after reading a byte into r1.
- *        Bridge checks: if byte=='\n', resume at L2 (send query).
- *        If byte!='\n', resume at L0 (read more). --
- *
- *   -- PHASE 2: Signal "send query" to bridge --
- *   L2:  movdbz r0, CMD_SEND_Q, L3, L3      ; r0 = SEND_QUERY (3)
- *   L3:  movdbz _, _, EXIT, EXIT             ; exit to bridge
- *
- *   -- PHASE 2b: Bridge resumes here after sending query --
- *
- *   -- PHASE 3: Signal "receive response" to bridge --
- *   L4:  movdbz r0, CMD_RECV_R, L5, L5      ; r0 = RECV_RESPONSE (4)
- *   L5:  movdbz _, _, EXIT, EXIT             ; exit to bridge
- *
- *   -- PHASE 3b: Bridge resumes here after response is fully received --
- *   -- Loop back to PHASE 1 (read next line) --
- *   L6:  movdbz r0, 1, L0, L0               ; jmp L0 (loop)
+ *   L_READ_CMD  r_cmd = READ_BYTE or READ_LINE, exit
+ *   L_SEND_CMD  r_cmd = SEND_QUERY, exit
+ *   L_RECV_CMD  r_cmd = RECV_RESPONSE, exit
+ *   L_LOOP      jump to L_READ_CMD (threaded away by the compiler)
  *
  * The bridge handles:
  *   - READ_BYTE: read char from keyboard/serial, check for newline/quit
- *   - SEND_QUERY: send accumulated prompt_buf over serial as "Q:...\n"
- *   - RECV_RESPONSE: read serial until EOT, display on VGA + echo to serial
+ *   - READ_LINE: edit a whole line in the bridge, resume at L_SEND_CMD
+ *   - SEND_QUERY: send accumulated prompt_buf over the wire as "Q:...\n"
+ *   - RECV_RESPONSE: read the answer, display on VGA + echo to serial
  *   - EXIT: halt
+ */
+
+#include "repl_prog.h"
+
+/* Entry labels of the compiled REPL program */
+#define L_READ_CMD      REPL_READ
+#define L_SEND_CMD      REPL_SEND
+#define L_RECV_CMD      REPL_RECV
+#define L_LOOP          REPL_LOOP
+#define NUM_REPL_INSTS  REPL_NUM_INSTS
+
+/* REPL register indices */
+#define R_CMD           REPL_REG_CMD
+#define R_DATA          REPL_REG_DATA
+#define R_TEMP          REPL_REG_TEMP
+
+/* Prebuilt images of the same programs, generated by tools/wmimage.c */
+#include "repl_image.h"
+
+/*
+ * line_mode selects the input command at L_READ_CMD: WM_IO_READ_BYTE
+ * exits to the bridge once per keystroke, WM_IO_READ_LINE once per line.
  *
- * Constants needed: CMD values (1, 3, 4), plus 1 for the loop-back.
+ * The prebuilt image is copied in unless `generate` is set or it does
+ * not match this engine; then the program is generated at runtime.
+ * `verify` does both and reports whether the pages are identical.
  */
+static int build_repl_program(int line_mode, int generate, int verify) {
+    const struct wm_program *prog = line_mode ? &repl_line_program : &repl_byte_program;
+    const struct wm_image *img = line_mode ? &repl_line_image : &repl_byte_image;
+
+    if (verify) {
+        int ok = wm_load_image(img) == 0 && wm_image_checksum() == img->checksum;
+        if (wm_load_program(prog) != 0)
+            return -1;
+        ok = ok && wm_image_checksum() == img->checksum;
+        vga_puts(ok ? "[init] Prebuilt image matches runtime generation\n"
+                    : "[init] Prebuilt image MISMATCH, using runtime generation\n");
+        serial_puts(ok ? "VERIFY:image ok\n" : "VERIFY:image mismatch\n");
+        return 0;
+    }
 
-/* Instruction labels for the movdbz REPL program */
-enum {
-    L_READ_CMD   = 0,   /* Set r0 = READ_BYTE */
-    L_READ_EXIT  = 1,   /* Exit to bridge */
-    L_SEND_CMD   = 2,   /* Set r0 = SEND_QUERY */
-    L_SEND_EXIT  = 3,   /* Exit to bridge */
-    L_RECV_CMD   = 4,   /* Set r0 = RECV_RESPONSE */
-    L_RECV_EXIT  = 5,   /* Exit to bridge */
-    L_LOOP       = 6,   /* Loop back to L0 */
-    NUM_REPL_INSTS = 7,
+    if (!generate && wm_load_image(img) == 0) {
+        vga_puts("[init] Loaded prebuilt movdbz program image\n");
+        return 0;
+    }
+    if (wm_load_program(prog) != 0)
+        return -1;
+    vga_puts("[init] Generated movdbz program at runtime\n");
+    return 0;
+}
+
+/* ========== Cascade Profiler ========== */
+
+#define STAT_BUCKETS  32    /* Histogram bucket b counts cycles in [2^b, 2^(b+1)) */
+#define NUM_IO_CMDS   (WM_IO_OUT_OF_FUEL + 1)
+
+struct cascade_stat {
+    uint32_t count;
+    uint64_t total;
+    uint64_t min;
+    uint64_t max;
+    uint32_t hist[STAT_BUCKETS];
 };
 
-/* REPL register indices */
+/* Cascade cost keyed by entry label and by the command it exited with */
+static struct cascade_stat label_stats[NUM_REPL_INSTS];
+static struct cascade_stat cmd_stats[NUM_IO_CMDS];
+
+static void stat_add(struct cascade_stat *st, uint64_t cycles) {
+    if (st->count == 0 || cycles < st->min) st->min = cycles;
+    if (cycles > st->max) st->max = cycles;
+    st->count++;
+    st->total += cycles;
+
+    int b = 0;
+    while (b < STAT_BUCKETS - 1 && (cycles >> (b + 1)))
+        b++;
+    st->hist[b]++;
+}
+
+/* Record the cascade that just returned after entering at `label` */
+static void profile_cascade(int label) {
+    uint64_t cycles = wm_last_cycles();
+    uint32_t cmd = wm_read_reg(R_CMD);
+
+    if (label >= 0 && label < NUM_REPL_INSTS)
+        stat_add(&label_stats[label], cycles);
+    if (cmd < NUM_IO_CMDS)
+        stat_add(&cmd_stats[cmd], cycles);
+}
+
+/* " <key><n> n=.. min=.. avg=.. max=.. hist=<bucket>:<count>,..." */
+static void stat_dump(const char *key, int n, const struct cascade_stat *st) {
+    if (st->count == 0) return;
+
+    wire_write(' ');
+    wire_puts(key);
+    put_dec(wire_write, n);
+    wire_puts(" n=");   put_dec(wire_write, st->count);
+    wire_puts(" min="); put_dec(wire_write, st->min);
+    wire_puts(" avg="); put_dec(wire_write, udiv64(st->total, st->count, NULL));
+    wire_puts(" max="); put_dec(wire_write, st->max);
+    wire_puts(" hist=");
+
+    int first = 1;
+    for (int b = 0; b < STAT_BUCKETS; b++) {
+        if (!st->hist[b]) continue;
+        if (!first) wire_write(',');
+        put_dec(wire_write, b);
+        wire_write(':');
+        put_dec(wire_write, st->hist[b]);
+        first = 0;
+    }
+    wire_write(';');
+}
+
+/*
+ * Wire protocol: "STATS: L<label> ...; cmd<code> ...;\n"
+ * All times are TSC cycles spent inside the fault cascade.
+ */
+static void stats_dump(void) {
+    wire_puts("STATS:");
+    for (int i = 0; i < NUM_REPL_INSTS; i++)
+        stat_dump("L", i, &label_stats[i]);
+    for (int i = 0; i < NUM_IO_CMDS; i++)
+        stat_dump("cmd", i, &cmd_stats[i]);
+    wire_write('\n');
+}
+
+/* Clear R_CMD, resume the weird machine at `label` and profile the run */
+static void repl_resume(int label) {
+    wm_write_reg(R_CMD, 0);
+    wm_resume(label);
+    profile_cascade(label);
+}
+
+/* ========== Line Editing ========== */
+
+/* line_edit() results */
 enum {
-    R_CMD  = 0,
-    R_DATA = 1,
-    R_TEMP = 2,
+    LINE_MORE,      /* Byte consumed, line not finished */
+    LINE_EMPTY,     /* Empty line */
+    LINE_QUERY,     /* Line in prompt_buf is a query */
+    LINE_QUIT,      /* "quit" */
+    LINE_STATS,     /* "stats" */
 };
 
-static void build_repl_program(void) {
-    /* Allocate user registers */
-    wm_write_reg(R_CMD, 0);
-    wm_write_reg(R_DATA, 0);
-    wm_write_reg(R_TEMP, 0);
+/* What a finished line is: LINE_QUIT, LINE_STATS, LINE_EMPTY or LINE_QUERY */
+static int line_kind(const char *buf, size_t len) {
+    if (len == 4 && streq(buf, "quit", 4))
+        return LINE_QUIT;
+    if (len == 5 && streq(buf, "stats", 5))
+        return LINE_STATS;
+    if (len == 0)
+        return LINE_EMPTY;
+    return LINE_QUERY;
+}
 
-    /* Allocate constants.
-     * movdbz computes: dst = src - 1.  So to get the desired command
-     * code N in R_CMD, the constant must be initialised to N + 1. */
-    int c_read  = wm_alloc_const(WM_IO_READ_BYTE + 1);      /* 2 → cmd 1 */
-    int c_sendq = wm_alloc_const(WM_IO_SEND_QUERY + 1);     /* 4 → cmd 3 */
-    int c_recvr = wm_alloc_const(WM_IO_RECV_RESPONSE + 1);  /* 5 → cmd 4 */
-    int c_one   = wm_alloc_const(1);                          /* loop-back */
+/*
+ * Apply one input byte to prompt_buf: echo, backspace, end-of-line.
+ * Shared by the byte-at-a-time and cooked line input commands.
+ */
+static int line_edit(char c) {
+    if (c == '\n' || c == '\r') {
+        /* End of line */
+        serial_write('\n');  /* Echo newline */
+        vga_putchar('\n');
+
+        int kind = line_kind(prompt_buf, prompt_len);
+        if (kind == LINE_STATS)
+            prompt_len = 0;
+        return kind;
+    }
 
-    /* L0: movdbz r0, c_read, L1, L1   -- r0 = READ_BYTE */
-    wm_gen_movdbz(L_READ_CMD,  R_CMD, c_read, L_READ_EXIT, L_READ_EXIT);
+    if (c == '\b' || c == 0x7f) {
+        /* Backspace */
+        if (prompt_len > 0) {
+            prompt_len--;
+            serial_write('\b');
+            serial_write(' ');
+            serial_write('\b');
+            vga_putchar('\b');
+        }
+        return LINE_MORE;
+    }
 
-    /* L1: movdbz discard, discard, EXIT, EXIT  -- exit to bridge */
-    wm_gen_movdbz(L_READ_EXIT, WM_REG_DISCARD, WM_REG_DISCARD, -1, -1);
+    /* Accumulate byte in buffer, echo it */
+    if (prompt_len < PROMPT_BUF_SIZE - 1) {
+        prompt_buf[prompt_len++] = c;
+    }
+    serial_write(c);    /* Echo to serial */
+    vga_set_color(VGA_WHITE, VGA_BLACK);
+    vga_putchar(c);     /* Echo to VGA */
+    return LINE_MORE;
+}
 
-    /* L2: movdbz r0, c_sendq, L3, L3  -- r0 = SEND_QUERY */
-    wm_gen_movdbz(L_SEND_CMD,  R_CMD, c_sendq, L_SEND_EXIT, L_SEND_EXIT);
+/* ========== Typeahead Pipelining ========== */
 
-    /* L3: movdbz discard, discard, EXIT, EXIT  -- exit to bridge */
-    wm_gen_movdbz(L_SEND_EXIT, WM_REG_DISCARD, WM_REG_DISCARD, -1, -1);
+#define PIPE_DEPTH      4       /* Queries sent ahead of the REPL, power of two */
 
-    /* L4: movdbz r0, c_recvr, L5, L5  -- r0 = RECV_RESPONSE */
-    wm_gen_movdbz(L_RECV_CMD,  R_CMD, c_recvr, L_RECV_EXIT, L_RECV_EXIT);
+static char pipe_buf[PROMPT_BUF_SIZE];      /* Tag byte, then the edited line */
+static uint8_t pipe_tags[PIPE_DEPTH];       /* Tags sent ahead, oldest first */
+static uint32_t pipe_head, pipe_tail;
+static uint8_t pipe_next_tag = 1;           /* 1..255: 0 tags a FRAME_QUERY */
+static int answer_tag;                      /* Tag the next answer must carry */
 
-    /* L5: movdbz discard, discard, EXIT, EXIT  -- exit to bridge */
-    wm_gen_movdbz(L_RECV_EXIT, WM_REG_DISCARD, WM_REG_DISCARD, -1, -1);
+/*
+ * Send finished typeahead lines that are queries as FRAME_PIPE frames,
+ * so the proxy can work on them while the current answer streams. Each
+ * line is edited exactly as line_edit() will replay it, and the replayed
+ * query is then not sent again (see WM_IO_SEND_QUERY). Nothing is sent
+ * past a "quit".
+ */
+static void typeahead_pipe(void) {
+    while (pipe_head - pipe_tail < PIPE_DEPTH) {
+        uint32_t end = ta_scan;
+        while (end != ta_head && typeahead[end & (TYPEAHEAD_SIZE - 1)] != '\n')
+            end++;
+        if (end == ta_head)
+            return;                     /* Line not finished yet */
+
+        size_t len = 0;
+        for (uint32_t i = ta_scan; i != end; i++) {
+            char c = typeahead[i & (TYPEAHEAD_SIZE - 1)];
+            if (c == '\b' || c == 0x7f) {
+                if (len > 0) len--;
+            } else if (len < PROMPT_BUF_SIZE - 1) {
+                pipe_buf[1 + len++] = c;
+            }
+        }
+        int kind = line_kind(pipe_buf + 1, len);
+        if (kind == LINE_QUIT)
+            return;
+        ta_scan = end + 1;
+        if (kind != LINE_QUERY)
+            continue;
+
+        uint8_t tag = pipe_next_tag;
+        pipe_next_tag = tag == 255 ? 1 : tag + 1;
+        pipe_buf[0] = (char)tag;
+        frame_send(FRAME_PIPE, pipe_buf, len + 1);
+        pipe_tags[pipe_head++ & (PIPE_DEPTH - 1)] = tag;
+    }
+}
 
-    /* L6: movdbz r_temp, c_one, L0, L0  -- unconditional jump to L0 */
-    wm_gen_movdbz(L_LOOP, R_TEMP, c_one, L_READ_CMD, L_READ_CMD);
+/*
+ * Wait until the wire has a byte for us, queueing keystrokes meanwhile
+ * and, if `pipe`, sending finished lines ahead. The UART interrupts on
+ * received data; the shared-memory ring has no interrupt and is polled.
+ */
+static void wire_wait(int pipe) {
+    while (1) {
+        typeahead_poll();
+        if (pipe)
+            typeahead_pipe();
+        if (wire->pending())
+            return;
+        vga_flush();
+        if (wire != &uart_transport) {
+            __asm__ volatile ("pause");
+            continue;
+        }
+        __asm__ volatile ("cli");
+        if (!kbd_has_key() && !serial_received())
+            __asm__ volatile ("sti; hlt");  /* sti shadow: no lost wakeup */
+        else
+            __asm__ volatile ("sti");
+    }
+}
 
-    /* Pre-generate all instruction pages */
-    wm_generate();
+static void repl_prompt(void) {
+    vga_set_color(VGA_LIGHT_GREEN, VGA_BLACK);
+    vga_puts("pagefault> ");
+}
+
+static void repl_quit(void) {
+    vga_set_color(VGA_YELLOW, VGA_BLACK);
+    vga_puts("[quit]\n");
+    wire_puts("BYE\n");
+}
+
+/* "stats": dump the cascade profile */
+static void repl_stats(void) {
+    vga_set_color(VGA_DARK_GREY, VGA_BLACK);
+    vga_puts("[cascade stats sent to the proxy]\n");
+    stats_dump();
 }
 
 /*
@@ -352,13 +1319,15 @@ static void io_bridge_loop(void) {
     prompt_len = 0;
     int need_prompt = 1;
 
-    serial_puts("READY\n");
+    wire_puts("READY\n");
+    wire_puts("CAPS:frame,ack,pipe\n");
 
     /* First launch: start at L0 (read command) */
     vga_set_color(VGA_DARK_GREY, VGA_BLACK);
     vga_puts("[weird machine: launching fault cascade]\n");
 
     wm_launch();
+    profile_cascade(L_READ_CMD);
 
     /* The weird machine has exited. Service I/O requests in a loop. */
     while (1) {
@@ -368,63 +1337,57 @@ static void io_bridge_loop(void) {
         case WM_IO_READ_BYTE: {
             /* Show prompt on VGA at the start of a new input line */
             if (need_prompt) {
-                vga_set_color(VGA_LIGHT_GREEN, VGA_BLACK);
-                vga_puts("pagefault> ");
+                repl_prompt();
                 need_prompt = 0;
             }
 
             /* Read one byte from keyboard or serial (whichever has data) */
-            char c = input_read();
-
-            if (c == '\n' || c == '\r') {
-                /* End of line */
-                serial_write('\n');  /* Echo newline */
-                vga_putchar('\n');
-
-                /* Check for "quit" */
-                if (prompt_len == 4 && streq(prompt_buf, "quit", 4)) {
-                    vga_set_color(VGA_YELLOW, VGA_BLACK);
-                    vga_puts("[quit]\n");
-                    serial_puts("BYE\n");
-                    return;
-                }
-
-                /* Empty line: skip query, read again */
-                if (prompt_len == 0) {
-                    need_prompt = 1;
-                    wm_write_reg(R_CMD, 0);
-                    wm_resume(L_READ_CMD);
-                    break;
-                }
-
+            switch (line_edit(input_read())) {
+            case LINE_QUIT:
+                repl_quit();
+                return;
+            case LINE_STATS:
+                repl_stats();
+                /* fall through */
+            case LINE_EMPTY:
+                /* Skip query, read again */
+                need_prompt = 1;
+                repl_resume(L_READ_CMD);
+                break;
+            case LINE_QUERY:
                 /* Resume weird machine at send-query phase */
                 need_prompt = 1;
-                wm_write_reg(R_CMD, 0);
-                wm_resume(L_SEND_CMD);
-            } else if (c == '\b' || c == 0x7f) {
-                /* Backspace */
-                if (prompt_len > 0) {
-                    prompt_len--;
-                    serial_write('\b');
-                    serial_write(' ');
-                    serial_write('\b');
-                    vga_putchar('\b');
+                repl_resume(L_SEND_CMD);
+                break;
+            default:
+                /* Resume weird machine at read-cmd (read next byte) */
+                repl_resume(L_READ_CMD);
+                break;
+            }
+            break;
+        }
+
+        case WM_IO_READ_LINE: {
+            /* Cooked mode: edit a whole line in the bridge and only
+             * resume the weird machine once there is a query to send. */
+            int result;
+            do {
+                if (need_prompt) {
+                    repl_prompt();
+                    need_prompt = 0;
                 }
-                wm_write_reg(R_CMD, 0);
-                wm_resume(L_READ_CMD);
-            } else {
-                /* Accumulate byte in buffer, echo it */
-                if (prompt_len < PROMPT_BUF_SIZE - 1) {
-                    prompt_buf[prompt_len++] = c;
+                result = line_edit(input_read());
+                if (result == LINE_QUIT) {
+                    repl_quit();
+                    return;
                 }
-                serial_write(c);    /* Echo to serial */
-                vga_set_color(VGA_WHITE, VGA_BLACK);
-                vga_putchar(c);     /* Echo to VGA */
+                if (result == LINE_STATS)
+                    repl_stats();
+                if (result != LINE_MORE)
+                    need_prompt = 1;
+            } while (result != LINE_QUERY);
 
-                /* Resume weird machine at read-cmd (read next byte) */
-                wm_write_reg(R_CMD, 0);
-                wm_resume(L_READ_CMD);
-            }
+            repl_resume(L_SEND_CMD);
             break;
         }
 
@@ -433,50 +1396,150 @@ static void io_bridge_loop(void) {
             prompt_buf[prompt_len] = '\0';
 
             vga_set_color(VGA_DARK_GREY, VGA_BLACK);
+            if (pipe_tail != pipe_head) {
+                /* typeahead_pipe() sent it while the last answer
+                 * streamed: just tell the proxy we are ready for it */
+                answer_tag = pipe_tags[pipe_tail++ & (PIPE_DEPTH - 1)];
+                vga_puts("[query was pipelined, receiving]\n");
+                wire_puts("NEXT:");
+                put_dec(wire_write, (uint64_t)answer_tag);
+                wire_write('\n');
+                prompt_len = 0;
+                repl_resume(L_RECV_CMD);
+                break;
+            }
+            answer_tag = 0;
             vga_puts("[sending query via fault cascade]\n");
 
-            /* Wire protocol: Q:<text>\n */
-            serial_puts("Q:");
-            for (size_t i = 0; i < prompt_len; i++)
-                serial_write(prompt_buf[i]);
-            serial_write('\n');
+            /* Wire protocol: Q:<text>\n, or a query frame */
+            if (proxy_framed) {
+                frame_send(FRAME_QUERY, prompt_buf, prompt_len);
+            } else {
+                wire_puts("Q:");
+                wire->write_bytes(prompt_buf, prompt_len);
+                wire_write('\n');
+            }
 
             /* Reset buffer for next prompt */
             prompt_len = 0;
 
             /* Resume weird machine at recv-response phase */
-            wm_write_reg(R_CMD, 0);
-            wm_resume(L_RECV_CMD);
+            repl_resume(L_RECV_CMD);
             break;
         }
 
         case WM_IO_RECV_RESPONSE: {
-            /* Read response from proxy: "A:<text>\x04" */
-            /* Skip "A:" prefix */
-            char c1 = serial_read();
-            char c2 = serial_read();
-            (void)c1; (void)c2;
-
-            /* Relay response bytes to VGA and serial (for proxy logging) */
+            /* Read response from proxy: "A:<text>\x04" or frames.
+             * Keystrokes typed meanwhile go to the typeahead queue. */
+            wire_wait(0);
+            char c1 = wire_read();
+
+            /* Relay response bytes to VGA and serial (for proxy logging).
+             * The proxy streams the answer as it is generated, so each
+             * byte is drawn as soon as it arrives rather than at EOT.
+             * Over shared memory the UART would throttle the relay to
+             * its baud rate, so only the length is logged there. A proxy
+             * that asks for an ack gets the length and CRC instead, so
+             * the answer crosses the link only once. */
+            int echo = wire == &uart_transport;
+            int ack = 0;
+            uint32_t answer_len = 0;
+            uint16_t answer_crc = 0xffff;
+            char type = 0;
+            int len = 0;
+            int tag = -1;               /* Untagged */
+            if (c1 == FRAME_SOH) {
+                proxy_framed = 1;
+                len = frame_recv(&type);
+                while (type == FRAME_ACKREQ || type == FRAME_PIPE) {
+                    if (type == FRAME_ACKREQ) {
+                        ack = 1;
+                        echo = 0;
+                    } else {
+                        proxy_pipe = 1;
+                        tag = len == 1 ? (uint8_t)frame_buf[0] : 256;
+                    }
+                    do wire_wait(0); while (wire_read() != FRAME_SOH);
+                    len = frame_recv(&type);
+                }
+            }
+            /* Typed-ahead queries only go out while nothing else does:
+             * a frame would land in the middle of the echo line */
+            int pipe = proxy_pipe && !echo;
             vga_set_color(VGA_LIGHT_CYAN, VGA_BLACK);
+            if (tag >= 0 && tag != answer_tag)
+                vga_puts("[answer out of order] ");
             vga_puts("Claude: ");
-            serial_puts("Claude: ");
-            while (1) {
-                char c = serial_read();
-                if (c == 0x04) break;
-                vga_putchar(c);
-                serial_write(c);
+            if (!ack)
+                serial_puts("Claude: ");
+            if (c1 == FRAME_SOH) {
+                /* Framed: bulk-copy each chunk, then draw it */
+                while (1) {
+                    if (len < 0) {
+                        vga_puts("[frame error]");
+                        if (!ack)
+                            serial_puts("[frame error]");
+                    }
+                    for (int i = 0; i < len; i++)
+                        vga_putchar(frame_buf[i]);
+                    if (len > 0) {
+                        answer_len += len;
+                        answer_crc = crc16_update(answer_crc, frame_buf, len);
+                    }
+                    vga_flush();                /* Once per chunk */
+                    if (echo && len > 0) {
+                        /* Never echo SOH: it would read as a frame */
+                        for (int i = 0; i < len; i++)
+                            if (frame_buf[i] == FRAME_SOH) frame_buf[i] = '?';
+                        serial_write_bytes(frame_buf, len);
+                    }
+                    if (type == FRAME_ANSWER) break;
+                    do wire_wait(pipe); while (wire_read() != FRAME_SOH);
+                    len = frame_recv(&type);
+                }
+            } else {
+                /* Text: skip the ':' of "A:", relay until EOT */
+                wire_read();
+                while (1) {
+                    wire_wait(0);               /* Flushes once caught up */
+                    char c = wire_read();
+                    if (c == 0x04) break;
+                    vga_putchar(c);
+                    if (echo)
+                        serial_write(c == FRAME_SOH ? '?' : c);
+                    answer_len++;
+                }
+            }
+            if (ack) {
+                wire_puts("ACK:");
+                put_dec(wire_write, answer_len);
+                wire_write(',');
+                put_dec(wire_write, answer_crc);
+                wire_write('\n');
+            } else {
+                if (!echo) {
+                    serial_write('[');
+                    put_dec(serial_write, answer_len);
+                    serial_puts(" bytes via shm]");
+                }
+                serial_write('\n');
             }
             vga_putchar('\n');
             vga_putchar('\n');
-            serial_write('\n');
 
             /* Resume weird machine at loop-back instruction */
-            wm_write_reg(R_CMD, 0);
-            wm_resume(L_LOOP);
+            repl_resume(L_LOOP);
             break;
         }
 
+        case WM_IO_OUT_OF_FUEL:
+            /* A long computation ran out of fuel (built with 'fuel N'):
+             * catch up on the display between slices, then carry on,
+             * refuelled, at the branch it stopped on */
+            vga_flush();
+            repl_resume(wm_fuel_target());
+            break;
+
         case WM_IO_EXIT:
         default:
             /* Program done or unknown command */
@@ -487,9 +1550,324 @@ static void io_bridge_loop(void) {
     }
 }
 
+/*
+ * ========== Accelerator ==========
+ *
+ * Under KVM every task switch and nested fault of a cascade traps to the
+ * host and is carried out by KVM's task switch emulation, not by QEMU's
+ * TCG CPU model. The cascade depends on the details of that path: the
+ * error-code push on the new task's stack, a fault in that push turning
+ * into #DF, and the busy-bit and TSS writes going through the outgoing
+ * page directory. So the mode is detected at boot and the cascade checked
+ * with a small program before anything relies on it.
+ */
+
+static void cpuid(uint32_t leaf, uint32_t r[4]) {
+    __asm__ volatile ("cpuid"
+                      : "=a"(r[0]), "=b"(r[1]), "=c"(r[2]), "=d"(r[3])
+                      : "a"(leaf), "c"(0));
+}
+
+/* "kvm", "tcg", or "hv" for another hypervisor. QEMU's TCG CPU models
+ * leave the hypervisor bit clear, so bare metal also reads as "tcg". */
+static const char *accel_name(void) {
+    uint32_t r[4];
+    cpuid(1, r);
+    if (!(r[2] & (1u << 31)))
+        return "tcg";
+    cpuid(0x40000000, r);
+    if (r[1] == 0x4b4d564b && r[2] == 0x564b4d56 && r[3] == 0x0000004d)
+        return "kvm";           /* "KVMKVMKVM\0\0\0" */
+    if (r[1] == 0x54474354 && r[2] == 0x43544743 && r[3] == 0x47435447)
+        return "tcg";           /* "TCGTCGTCGTCG" */
+    return "hv";
+}
+
+/*
+ * Exercise both branch kinds, a self-loop and a NOP-relayed branch:
+ *   L0: movdbz r1, r0, L4, L1     ; r0 = 0: #DF path
+ *   L1: movdbz r2, r2, L1, L2     ; countdown from 3
+ *   L2: movdbz r1, r3, L3, L4     ; r3 = 1: #PF path
+ *   L3: movdbz r4, c2, EXIT, EXIT ; pass: r4 = 1
+ *   L4: movdbz r5, c2, EXIT, EXIT ; wrong branch: r5 = 1
+ * Returns 0 if the cascade computed the right result.
+ */
+static int cascade_selftest(void) {
+    static const uint32_t init[] = { 0, 0, 3, 1, 0, 0 };
+    wm_reset();
+    wm_write_regs(0, init, 6);
+    int c2 = wm_alloc_const(2);
+
+    wm_gen_movdbz(0, 1, 0, 4, 1);
+    wm_gen_movdbz(1, 2, 2, 1, 2);
+    wm_gen_movdbz(2, 1, 3, 3, 4);
+    wm_gen_movdbz(3, 4, c2, -1, -1);
+    wm_gen_movdbz(4, 5, c2, -1, -1);
+    wm_generate();
+    wm_launch();
+
+    int ok = wm_read_reg(4) == 1 && wm_read_reg(5) == 0 && wm_read_reg(2) == 0;
+    wm_reset();
+    return ok ? 0 : -1;
+}
+
+/*
+ * ========== Benchmark Mode ==========
+ *
+ * Booted with "bench" on the kernel command line, the kernel runs a set
+ * of dedicated movdbz programs instead of the REPL and reports each as
+ *   "BENCH:<name> start\n"
+ *   "BENCH:<name> movdbz=<count> switches=<count> cycles=<tsc cycles>\n"
+ * ending with "BENCH:done\n". The host (bench.py) times the lines to
+ * turn cycle counts into wall-clock rates. Task switches are counted
+ * from each branch's cost (wm_branch_switches()), since only some
+ * branches go through a NOP.
+ *
+ * Registers hold at most 1024 (ESP = value * 4 must stay on the stack
+ * page), so longer runs use nested counters.
+ */
+
+#define BENCH_INNER       1000
+#define BENCH_OUTER       100
+#define BENCH_BR_INNER    100
+#define BENCH_BR_OUTER    200
+#define BENCH_RESUMES     10000
+
+/* Task switches of a branch of movdbz i, taken n times */
+#define SW(i, zero, n)  ((uint64_t)(n) * wm_branch_switches(i, zero))
+
+static void bench_report(const char *name, uint64_t movdbz, uint64_t switches,
+                         uint64_t cycles) {
+    serial_puts("BENCH:");
+    serial_puts(name);
+    serial_puts(" movdbz=");
+    put_dec(serial_write, movdbz);
+    serial_puts(" switches=");
+    put_dec(serial_write, switches);
+    serial_puts(" cycles=");
+    put_dec(serial_write, cycles);
+    serial_write('\n');
+}
+
+static void bench_start(const char *name) {
+    vga_puts("[bench] ");
+    vga_puts(name);
+    vga_putchar('\n');
+    serial_puts("BENCH:");
+    serial_puts(name);
+    serial_puts(" start\n");
+}
+
+/*
+ * Tight countdown loop:
+ *   L0: movdbz r0, r0, L0, L1     ; inner countdown
+ *   L1: movdbz r0, c_in, L2, L2   ; r0 = INNER
+ *   L2: movdbz r1, r1, L0, L3     ; outer countdown
+ *   L3: movdbz _, _, EXIT, EXIT
+ */
+#define COUNTDOWN_MOVDBZ  ((uint64_t)(BENCH_OUTER + 1) * (BENCH_INNER + 3) + 1)
+
+static void countdown_load(void) {
+    static const uint32_t init[] = { BENCH_INNER, BENCH_OUTER };
+    wm_reset();
+    wm_write_regs(0, init, 2);
+    int c_in = wm_alloc_const(BENCH_INNER + 1);
+
+    wm_gen_movdbz(0, 0, 0, 0, 1);
+    wm_gen_movdbz(1, 0, c_in, 2, 2);
+    wm_gen_movdbz(2, 1, 1, 0, 3);
+    wm_gen_movdbz(3, WM_REG_DISCARD, WM_REG_DISCARD, -1, -1);
+    wm_generate();
+}
+
+static uint64_t countdown_switches(void) {
+    return WM_ENTRY_SWITCHES
+           + SW(0, 0, (BENCH_OUTER + 1) * BENCH_INNER)
+           + SW(0, 1, BENCH_OUTER + 1) + SW(1, 0, BENCH_OUTER + 1)
+           + SW(2, 0, BENCH_OUTER) + SW(2, 1, 1) + SW(3, 0, 1);
+}
+
+static void bench_countdown(void) {
+    countdown_load();
+    bench_start("countdown");
+    wm_launch();
+    bench_report("countdown", COUNTDOWN_MOVDBZ, countdown_switches(),
+                 wm_last_cycles());
+}
+
+/*
+ * The countdown on every CPU at once, each on its own instance:
+ *   "BENCH:smp cpus=<n> movdbz=<total> switches=<total> cycles=<slowest>"
+ */
+static uint64_t smp_switches[WM_MAX_CPUS];
+static uint64_t smp_cycles[WM_MAX_CPUS];
+
+static void smp_countdown(void) {
+    countdown_load();
+    wm_launch();
+    smp_switches[wm_cpu()] = countdown_switches();
+    smp_cycles[wm_cpu()] = wm_last_cycles();
+}
+
+static void bench_smp(void) {
+    bench_start("smp");
+    for (int cpu = 1; cpu < num_cpus; cpu++)
+        smp_post(cpu, smp_countdown);
+    smp_countdown();
+
+    uint64_t switches = 0, cycles = 0;
+    for (int cpu = 0; cpu < num_cpus; cpu++) {
+        smp_wait(cpu);
+        switches += smp_switches[cpu];
+        if (smp_cycles[cpu] > cycles)
+            cycles = smp_cycles[cpu];
+    }
+    serial_puts("BENCH:smp cpus=");
+    put_dec(serial_write, (uint64_t)num_cpus);
+    serial_puts(" movdbz=");
+    put_dec(serial_write, COUNTDOWN_MOVDBZ * (uint64_t)num_cpus);
+    serial_puts(" switches=");
+    put_dec(serial_write, switches);
+    serial_puts(" cycles=");
+    put_dec(serial_write, cycles);
+    serial_write('\n');
+}
+
+/*
+ * Branch-heavy loop: half of all branches take the #DF (zero) path.
+ *   L0: movdbz r0, c2, L1, L1     ; r0 = 1
+ *   L1: movdbz r0, r0, L1, L2     ; nz once, then z
+ *   L2: movdbz r1, r1, L0, L3     ; inner countdown
+ *   L3: movdbz r1, c_in, L4, L4   ; r1 = INNER
+ *   L4: movdbz r2, r2, L0, L5     ; outer countdown
+ *   L5: movdbz _, _, EXIT, EXIT
+ */
+static void bench_branch(void) {
+    static const uint32_t init[] = { 0, BENCH_BR_INNER, BENCH_BR_OUTER };
+    wm_reset();
+    wm_write_regs(0, init, 3);
+    int c2   = wm_alloc_const(2);
+    int c_in = wm_alloc_const(BENCH_BR_INNER + 1);
+
+    wm_gen_movdbz(0, 0, c2, 1, 1);
+    wm_gen_movdbz(1, 0, 0, 1, 2);
+    wm_gen_movdbz(2, 1, 1, 0, 3);
+    wm_gen_movdbz(3, 1, c_in, 4, 4);
+    wm_gen_movdbz(4, 2, 2, 0, 5);
+    wm_gen_movdbz(5, WM_REG_DISCARD, WM_REG_DISCARD, -1, -1);
+    wm_generate();
+
+    bench_start("branch");
+    wm_launch();
+    bench_report("branch",
+                 (uint64_t)(BENCH_BR_OUTER + 1) * (4 * (BENCH_BR_INNER + 1) + 2) + 1,
+                 WM_ENTRY_SWITCHES
+                 + (SW(0, 0, BENCH_BR_INNER + 1) + SW(1, 0, BENCH_BR_INNER + 1)
+                    + SW(1, 1, BENCH_BR_INNER + 1) + SW(2, 0, BENCH_BR_INNER)
+                    + SW(2, 1, 1) + SW(3, 0, 1)) * (BENCH_BR_OUTER + 1)
+                 + SW(4, 0, BENCH_BR_OUTER) + SW(4, 1, 1) + SW(5, 0, 1),
+                 wm_last_cycles());
+}
+
+/*
+ * Resume storm: one exit instruction resumed over and over, measuring
+ * the bridge-to-cascade round trip. Also reports min/max per resume.
+ */
+static void bench_resume(void) {
+    wm_reset();
+    wm_gen_movdbz(0, WM_REG_DISCARD, WM_REG_DISCARD, -1, -1);
+    wm_generate();
+
+    struct cascade_stat st = { 0 };
+    bench_start("resume");
+    for (int i = 0; i < BENCH_RESUMES; i++) {
+        wm_resume(0);
+        stat_add(&st, wm_last_cycles());
+    }
+    serial_puts("BENCH:resume movdbz=");
+    put_dec(serial_write, st.count);
+    serial_puts(" cycles=");
+    put_dec(serial_write, st.total);
+    serial_puts(" min=");
+    put_dec(serial_write, st.min);
+    serial_puts(" max=");
+    put_dec(serial_write, st.max);
+    serial_write('\n');
+}
+
+static void bench_run(const char *accel) {
+    serial_puts("ACCEL:");
+    serial_puts(accel);
+    serial_puts(" selftest=ok\n");
+    vga_set_color(VGA_YELLOW, VGA_BLACK);
+    bench_countdown();
+    bench_branch();
+    bench_resume();
+    bench_smp();
+    serial_puts("BENCH:done\n");
+}
+
+/* ========== Multiboot ========== */
+
+#define MULTIBOOT_MAGIC       0x2BADB002
+#define MULTIBOOT_INFO_MEMORY  0x001
+#define MULTIBOOT_INFO_CMDLINE 0x004
+
+/* End of the RAM above 1MB (0 if the loader did not say) */
+static uint32_t multiboot_mem_end(uint32_t magic, const uint32_t *mbi) {
+    if (magic != MULTIBOOT_MAGIC || !(mbi[0] & MULTIBOOT_INFO_MEMORY))
+        return 0;
+    uint32_t kb = mbi[2];
+    if (kb > 0xC0000000u / 1024 - 1024)
+        kb = 0xC0000000u / 1024 - 1024;     /* Keep clear of the MMIO hole */
+    return 0x100000 + kb * 1024;
+}
+
+/* Does the multiboot command line contain `word` as a separate word? */
+static int cmdline_has(uint32_t magic, const uint32_t *mbi, const char *word) {
+    if (magic != MULTIBOOT_MAGIC || !(mbi[0] & MULTIBOOT_INFO_CMDLINE))
+        return 0;
+
+    const char *p = (const char *)mbi[4];
+    size_t n = 0;
+    while (word[n]) n++;
+
+    while (*p) {
+        while (*p == ' ') p++;
+        size_t len = 0;
+        while (p[len] && p[len] != ' ') len++;
+        if (len == n && streq(p, word, n))
+            return 1;
+        p += len;
+    }
+    return 0;
+}
+
 /* ========== Kernel Main ========== */
 
-void kernel_main(void) {
+/* Report why the kernel cannot go on, on screen and to the proxy, and
+ * exit QEMU with a failure status (isa-debug-exit: (1 << 1) | 1 = 3) */
+static void boot_fail(const char *why) {
+    vga_set_color(VGA_LIGHT_RED, VGA_BLACK);
+    vga_puts("[fatal] ");
+    vga_puts(why);
+    vga_putchar('\n');
+    serial_puts("ERROR:");
+    serial_puts(why);
+    serial_puts("\n");
+    outb(0x501, 0x01);
+    while (1) __asm__ volatile ("cli; hlt");
+}
+
+void kernel_main(uint32_t magic, const uint32_t *mbi) {
+    /* Read the command line while everything is still reachable: paging
+     * maps only low memory, the kernel and the program regions */
+    uint32_t mem_end = multiboot_mem_end(magic, mbi);
+    int bench = cmdline_has(magic, mbi, "bench");
+    int line_mode = cmdline_has(magic, mbi, "line");
+    int noimage = cmdline_has(magic, mbi, "noimage");
+    int verify = cmdline_has(magic, mbi, "verify");
+
     vga_init();
     serial_init();
     kbd_init();
@@ -506,11 +1884,41 @@ void kernel_main(void) {
     /* Set up the page fault weird machine */
     vga_set_color(VGA_YELLOW, VGA_BLACK);
     vga_puts("[init] Setting up page fault weird machine...\n");
-    wm_setup();
+    if (wm_setup(mem_end) != 0)
+        boot_fail("not enough RAM for the program regions");
+    interrupts_init();
+    smp_init();
+    vga_puts("[init] CPUs: ");
+    put_dec(vga_putchar, (uint64_t)num_cpus);
+    vga_putchar('\n');
+
+    const char *accel = accel_name();
+    int selftest = cascade_selftest();
+    vga_puts("[init] Accelerator: ");
+    vga_puts(accel);
+    vga_puts(selftest ? ", cascade self-test FAILED\n" : ", cascade self-test ok\n");
+    if (selftest) {
+        /* Every REPL step and benchmark is a cascade: none can be trusted */
+        serial_puts("ACCEL:");
+        serial_puts(accel);
+        serial_puts(" selftest=fail\n");
+        boot_fail("cascade self-test failed");
+    }
+    transport_init();
+    vga_puts("[init] Proxy transport: ");
+    vga_puts(wire->name);
+    vga_putchar('\n');
+
+    if (bench) {
+        bench_run(accel);
+        outb(0x501, 0x00);
+        while (1) __asm__ volatile ("hlt");
+    }
 
     /* Build the REPL program in movdbz */
     vga_puts("[init] Building movdbz REPL program...\n");
-    build_repl_program();
+    if (build_repl_program(line_mode, noimage, verify) != 0)
+        boot_fail("REPL program does not fit its region");
 
     vga_set_color(VGA_LIGHT_GREEN, VGA_BLACK);
     vga_puts("[init] Ready. Type in the QEMU window. 'quit' to exit.\n\n");
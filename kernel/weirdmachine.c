@@ -8,19 +8,31 @@
  *
  * Based on Bangert/Bratus (WOOT'13) and kristerw/instless_comp.
  *
- * Memory layout (physical pages starting at PROG_BASE_ADDR):
+ * Memory layout of an instance (physical pages from its region base,
+ * PROG_BASE_ADDR for instance 0):
  *   Page 0:    Stack page
  *   Page 1:    Stack page table
  *   Page 2:    GDT page table
- *   Page 3-6:  GDT (4 pages = 16KB, holds TSS descriptors)
- *   Page 7:    Initial page directory
- *   Page 8:    Initial page table for INST_ADDRESS range
- *   Page 9:    Initial instruction page (first TSS head)
- *   Page 10:   REG_CONST_ONE (constant register = 1)
- *   Page 11:   REG_DISCARD (write sink)
- *   Page 12+:  User registers (r0, r1, ...)
- *   After regs: Constant registers
- *   After consts: Instruction pages (4 pages per real instruction)
+ *   Page 3+:   GDT (page 0 plus one page per TSS slot, holds descriptors)
+ *   Then:      REG_CONST_ONE (constant register = 1)
+ *   Then:      REG_DISCARD (write sink)
+ *   Then:      Shared IDT page pool (one page per distinct #PF/#DF pair)
+ *   Then:      User registers (r0, r1, ...), from REG_R0_PAGE
+ *   After regs: Constant registers (one per distinct value)
+ *   After consts: Entry page directories (2 pages per movdbz instruction)
+ *   After entries: Instruction pages (3 pages per real instruction), last
+ *              so NOPs added by wm_patch_branch() can be appended
+ *
+ * Each region is identity-mapped, by the 4MB PSE entries that cover it,
+ * in every instruction page directory. Instance 0's starts at
+ * PROG_BASE_ADDR, just above the kernel's 4MB page, and is sized from RAM
+ * by wm_setup(); the other instances' regions are WM_REGION_PAGES long
+ * and stacked down from the end of RAM. A program whose pages do not fit
+ * in its region is rejected by wm_generate().
+ *
+ * Built with WM_HOSTGEN, only the page generation code is compiled, for
+ * the host: tools/wmimage.c includes this file to produce prebuilt
+ * program images (see wm_load_image()) with exactly the kernel's code.
  */
 
 #include "weirdmachine.h"
@@ -29,23 +41,69 @@
 
 /* ========== Address Space Layout ========== */
 
+/*
+ * Linear addresses, the same in every page directory. Only low memory,
+ * the kernel's 4MB page and the program regions are backed by RAM
+ * (identity-mapped), so the whole machine fits in 32MB of guest RAM:
+ * STACK/INST/GDT are remapped per instruction page directory, and the
+ * normal-mode GDTs behind GDT_ADDRESS live in the kernel image.
+ */
 #define STACK_ADDRESS       0x00000000   /* PDE[0] */
 #define INST_ADDRESS        0x00400000   /* PDE[1] - instruction + IDT */
 #define IDT_ADDRESS         INST_ADDRESS /* IDT is first page of INST range */
+#define GDT_ADDRESS         0x00800000   /* PDE[2] - GDT */
 #define X86_BASE_ADDRESS    0x00c00000   /* PDE[3] - kernel code */
-#define GDT_ADDRESS         0x01800000   /* PDE[6] - GDT */
-#define X86_PD_ADDRESS      0x07c00000   /* Normal x86 page directory */
-#define PROG_BASE_ADDR      0x08000000   /* All program pages */
+#define PROG_BASE_ADDR      0x01000000   /* PDE[4]+ - all program pages */
+#define X86_TSS_ADDRESS     0x00fff000   /* x86 kernel TSS, placed by linker.ld */
 
-#define PROG_BASE_PAGE      (PROG_BASE_ADDR >> 12)
+/* Convert an instance's program page number to its physical address */
+#define PAGE2PHYS(w, x)     ((w)->base + ((uint32_t)(x) << 12))
 
 /* Convert program page number to virtual address */
-#define PAGE2VIRT(x)        ((uint32_t *)((PROG_BASE_ADDR) + ((x) << 12)))
+#ifdef WM_HOSTGEN
+static uint32_t *wm_host_image;          /* Host buffer standing in for the region */
+#define PAGE2VIRT(w, x)     ((void)(w), wm_host_image + ((size_t)(x) << 10))
+#else
+#define PAGE2VIRT(w, x)     ((uint32_t *)PAGE2PHYS(w, x))
+#endif
 
 /* Page table flags */
 #define PG_P    0x001   /* Present */
 #define PG_W    0x002   /* Writable */
 #define PG_PS   0x080   /* Page Size (4MB) */
+#define PG_G    0x100   /* Global (survives CR3 reloads when CR4.PGE is set) */
+
+#define CR4_PSE 0x010   /* Page Size Extensions */
+#define CR4_PGE 0x080   /* Page Global Enable */
+
+/*
+ * Mappings that translate identically in every page directory (kernel
+ * code and the program region) are marked global so their TLB entries
+ * survive the CR3 load of each task switch. The GDT mapping cannot be:
+ * GDT_ADDRESS points at the program GDT pages in instruction PDs but at
+ * the physical GDT in the x86 PD. Build with WM_GLOBAL_PAGES=0 to compare.
+ */
+#ifndef WM_GLOBAL_PAGES
+#define WM_GLOBAL_PAGES 1
+#endif
+
+#if WM_GLOBAL_PAGES
+#define PG_SHARED PG_G
+#else
+#define PG_SHARED 0
+#endif
+
+/*
+ * Number of TSS slots instructions are spread over (see assign_slots()).
+ * Each costs a GDT page, and the IDT pool grows with its square.
+ */
+#ifndef WM_TSS_SLOTS
+#define WM_TSS_SLOTS 4
+#endif
+
+#if WM_TSS_SLOTS < 4 || WM_TSS_SLOTS > 15
+#error "WM_TSS_SLOTS must be 4..15 (one GDT page each, 64KB GDT limit)"
+#endif
 
 /* ========== Program Page Assignments ========== */
 
@@ -53,36 +111,162 @@
 #define STACK_PT_PAGE       1
 #define GDT_PT_PAGE         2
 #define GDT_PAGE0           3
-#define GDT_PAGE1           4
-#define GDT_PAGE2           5
-#define GDT_PAGE3           6
-#define INIT_PD             7
-#define INIT_PT             8
-#define INIT_INST           9
-#define REG_CONST_ONE_PAGE  10
-#define REG_DISCARD_PAGE    11
-#define REG_R0_PAGE         12
-
-/* Instruction page offsets within each 4-page group */
+#define GDT_PAGES           (WM_TSS_SLOTS + 1)
+#define REG_CONST_ONE_PAGE  (GDT_PAGE0 + GDT_PAGES)
+#define REG_DISCARD_PAGE    (REG_CONST_ONE_PAGE + 1)
+#define IDT_POOL_PAGE       (REG_DISCARD_PAGE + 1)
+#define IDT_POOL_PAGES      ((WM_TSS_SLOTS + 1) * (WM_TSS_SLOTS + 1))  /* #PF x #DF selectors */
+#define REG_R0_PAGE         (IDT_POOL_PAGE + IDT_POOL_PAGES)
+
+/* Instruction page offsets within each 3-page group */
 #define PD_OFF              0   /* Page directory */
 #define INST_PT_OFF         1   /* Page table for INST_ADDRESS range */
 #define INST_OFF            2   /* Instruction page (TSS head) */
-#define IDT_OFF             3   /* IDT page */
 
-#define PAGES_PER_INST      4
+#define PAGES_PER_INST      3
+
+/* Real instructions: each movdbz, plus at most one NOP per branch and
+ * one entry NOP (see assign_slots()) */
+#define MAX_REAL_INSTS      (4 * MAX_ASM_INSTS)
 
-/* ========== Module State ========== */
+/* Entry page offsets within each 2-page group (one group per movdbz).
+ * The entry PT sits at INST_PT_OFF so generate_pagetable() can build it. */
+#define ENTRY_PD_OFF        0
+#define PAGES_PER_ENTRY     2
+
+/*
+ * Program region sizes in pages. The fixed pages and MAX_REGISTERS
+ * registers take REG_R0_PAGE + MAX_REGISTERS; the rest holds 2 pages
+ * per movdbz and 3 per real instruction. FULL_REGION_PAGES holds
+ * MAX_ASM_INSTS with every NOP (about 14.4MB). Instance 0, which runs
+ * the REPL and prebuilt images, gets up to that much of the RAM left
+ * once the other instances' regions are set aside: about 270 movdbz,
+ * each with a NOP, in 32MB, and all of MAX_ASM_INSTS from 48MB. The
+ * others run only small kernel programs (the self-test, bench workers)
+ * and get WM_REGION_PAGES each, which fits about 20 such movdbz.
+ */
+#define FULL_REGION_PAGES   (REG_R0_PAGE + MAX_REGISTERS \
+                             + PAGES_PER_ENTRY * MAX_ASM_INSTS \
+                             + PAGES_PER_INST * MAX_REAL_INSTS)
 
-static int num_user_regs;       /* Number of user registers (r0, r1, ...) */
-static int num_const_regs;      /* Number of constant registers */
-static int first_inst_page;     /* Page number of first instruction */
-static int num_asm_insts;       /* Number of movdbz assembly instructions */
+#ifndef WM_REGION_PAGES
+#define WM_REGION_PAGES     256
+#endif
 
-/* x86 kernel TSS (saved state for returning from weird machine) */
-static uint32_t x86_tss[26] __attribute__((aligned(128)));
+#if WM_REGION_PAGES < REG_R0_PAGE + MAX_REGISTERS + 16 || WM_REGION_PAGES > 4096
+#error "WM_REGION_PAGES must cover the fixed pages and registers, plus 16 (at most 4096)"
+#endif
+
+/* TSS descriptor busy bit (type 0x89 -> 0x8B), in the high DWORD */
+#define TSS_BUSY            0x200
+
+/* ========== Instances ========== */
+
+/*
+ * One weird machine instance per CPU, each with its own program region,
+ * GDT and x86 TSS, so the CPUs run separate programs in parallel. The
+ * instance's GDT lives in its own 64KB window above GDT_ADDRESS: that is
+ * what GDTR holds on its CPU, in normal mode and mid-cascade alike, so
+ * sgdt tells which instance a caller is (see self()). Instance 0 has
+ * exactly the single-CPU layout, which prebuilt images depend on.
+ */
+#define GDT_WINDOW          0x10000
+#define AP_REGION_SIZE      ((uint32_t)WM_REGION_PAGES << 12)
+
+/* Movdbz instructions as recorded by wm_gen_movdbz(), laid out as real
+ * instructions by wm_generate(). Real instruction i < num_asm_insts is
+ * movdbz i itself; the rest are NOPs that relay to a single target. */
+struct real_inst {
+    int16_t nz, z;              /* Successor real instructions, -1 = exit */
+    int16_t dest_page;          /* Register page saved to when left */
+    int16_t src_page;           /* Register page loaded when entered */
+    uint8_t slot;               /* TSS slot */
+};
+
+struct wm_ctx {
+    int index;                  /* CPU / instance number */
+    uint32_t base;              /* Program region address (identity-mapped) */
+    uint32_t pages;             /* Program region size in pages */
+
+    int num_user_regs;          /* Number of user registers (r0, r1, ...) */
+    int num_const_regs;         /* Number of constant registers */
+    int first_inst_page;        /* Page number of first instruction */
+    int num_asm_insts;          /* Number of movdbz assembly instructions */
+    int first_entry_page;       /* Page number of first entry page directory */
+    int fuel_reg;               /* Fuel register (-1 = none), target register after it */
+    uint32_t fuel_budget;       /* Fuel loaded by every launch */
+    int fuel_insts;             /* User movdbz before the fuel checks */
+    uint64_t last_cycles;       /* TSC cycles spent in the last launch_at() */
+    uint32_t host_idt_base;     /* Normal-mode IDT restored on exit (0 = none) */
+    uint16_t host_idt_limit;
+
+    /* Interned read-only pages. An IDT page is fully determined by its
+     * (#PF selector, #DF selector) pair and a constant register by its
+     * value, so identical ones are generated once and shared. */
+    int num_idt_pages;                      /* Used IDT pool pages */
+    uint32_t idt_page_key[IDT_POOL_PAGES];  /* (tss_pf << 16) | tss_df */
+    uint32_t const_value[MAX_REGISTERS];    /* Value of each constant */
+    int const_reg[MAX_REGISTERS];           /* Register number of each */
+
+    struct wm_inst movdbz[MAX_ASM_INSTS];
+    struct real_inst insts[MAX_REAL_INSTS];
+    int num_real_insts;
+    int16_t entry_inst[MAX_ASM_INSTS];      /* NOP each movdbz is entered by */
+};
+
+static struct wm_ctx ctxs[WM_MAX_CPUS];
+
+#ifndef WM_HOSTGEN
+/* End of the program regions (the mapped part of RAM), set by wm_setup() */
+static uint32_t region_end;
+#endif
+
+/* x86 kernel TSS of each CPU (saved state for returning from the weird
+ * machine). Instance 0's address is baked into the program GDT pages,
+ * so linker.ld places the array at X86_TSS_ADDRESS and prebuilt images
+ * stay valid across kernel builds. */
+#define X86_TSS_STRIDE      128
+#define X86_TSS_ADDR(w)     (X86_TSS_ADDRESS + (uint32_t)(w)->index * X86_TSS_STRIDE)
+#ifndef WM_HOSTGEN
+static uint32_t x86_tss[WM_MAX_CPUS][X86_TSS_STRIDE / 4]
+    __attribute__((section(".bss.x86_tss"), aligned(X86_TSS_STRIDE)));
+
+/* Normal x86 page directory, and the page table that maps each
+ * instance's GDT window onto its normal-mode GDT pages below */
+static uint32_t x86_pd[1024] __attribute__((aligned(4096)));
+static uint32_t x86_gdt_pt[1024] __attribute__((aligned(4096)));
+static uint32_t x86_gdt[WM_MAX_CPUS][GDT_PAGES * 1024] __attribute__((aligned(4096)));
+#define X86_PD_ADDRESS      ((uint32_t)x86_pd)
+#endif
+
+/* GDT linear address of an instance */
+#define GDT_ADDR(w)         (GDT_ADDRESS + (uint32_t)(w)->index * GDT_WINDOW)
+
+/* The calling CPU's instance */
+static struct wm_ctx *self(void) {
+#ifdef WM_HOSTGEN
+    ctxs[0].base = PROG_BASE_ADDR;     /* Images are always instance 0, */
+    ctxs[0].pages = FULL_REGION_PAGES; /* as large as it can be at runtime */
+    return &ctxs[0];
+#else
+    struct __attribute__((__packed__)) {
+        uint16_t limit;
+        uint32_t base;
+    } gdtr;
+    __asm__ ("sgdtl %0" : "=m"(gdtr));
+    uint32_t i = (gdtr.base - GDT_ADDRESS) / GDT_WINDOW;
+    return &ctxs[i < WM_MAX_CPUS ? i : 0];
+#endif
+}
+
+/* EFLAGS loaded by every instruction TSS: reserved bit 1 only, so no
+ * IRQs mid-cascade and the same pages whichever code generates them */
+#define WM_TSS_EFLAGS       0x00000002
 
 /* ========== CR/Control Register Access ========== */
 
+#ifndef WM_HOSTGEN
+
 static inline uint32_t read_cr0(void) {
     uint32_t val;
     __asm__ volatile ("mov %%cr0, %0" : "=r"(val));
@@ -107,12 +291,27 @@ static inline void write_cr4(uint32_t val) {
     __asm__ volatile ("mov %0, %%cr4" : : "r"(val));
 }
 
+static inline uint64_t read_tsc(void) {
+    uint32_t lo, hi;
+    __asm__ volatile ("rdtsc" : "=a"(lo), "=d"(hi));
+    return ((uint64_t)hi << 32) | lo;
+}
+
 static inline uint32_t read_eflags(void) {
     uint32_t val;
     __asm__ volatile ("pushfl; popl %0" : "=r"(val));
     return val;
 }
 
+static inline void write_eflags(uint32_t val) {
+    __asm__ volatile ("pushl %0; popfl" : : "r"(val) : "memory", "cc");
+}
+
+#define EFLAGS_IF   0x00000200  /* Interrupt enable */
+#define EFLAGS_NT   0x00004000  /* Nested task */
+
+#endif /* !WM_HOSTGEN */
+
 /* ========== Memory Utilities ========== */
 
 static void memset32(uint32_t *dst, uint32_t val, size_t count) {
@@ -120,6 +319,11 @@ static void memset32(uint32_t *dst, uint32_t val, size_t count) {
         dst[i] = val;
 }
 
+/* Pages of the program region used by the current program */
+static uint32_t image_pages(struct wm_ctx *w) {
+    return w->first_inst_page + w->num_real_insts * PAGES_PER_INST;
+}
+
 /* ========== Segment Descriptor Encoding ========== */
 
 /*
@@ -139,32 +343,34 @@ static void encode_seg_descr(uint32_t *p, uint32_t type, uint32_t g,
             | ((base & 0x00ff0000) >> 16));
 }
 
-/* ========== TSS Slot Rotation ========== */
+/* ========== TSS Slots ========== */
 
 /*
- * Map instruction number to one of 3 rotating TSS GDT selectors.
- * -1 = exit (return to x86 TSS at selector 0x18).
+ * TSS slot s has its descriptor in the last 8 bytes of GDT page s + 1
+ * and its TSS at offset 0xFFD0 of the (s + 1)th 64KB step of the
+ * INST_ADDRESS range, so the descriptor lands where the TSS head's
+ * EAX/ECX fields are saved (see map_dest_tss()).
  */
-static uint32_t inst_to_tss_selector(int inst_nr) {
-    if (inst_nr < 0) return 0x18;   /* Exit: x86 kernel TSS */
-    switch (inst_nr % 3) {
-        case 0:  return 0x1ff8;
-        case 1:  return 0x2ff8;
-        default: return 0x3ff8;
-    }
+static uint32_t slot_selector(int slot) {
+    return ((uint32_t)(slot + 1) << 12) | 0xff8;
+}
+
+static uint32_t slot_tss_addr(int slot) {
+    return INST_ADDRESS + ((uint32_t)(slot + 1) << 16) - 0x30;
 }
 
 /*
- * Map instruction number to its TSS virtual address.
- * The TSS is placed at offset 0xFFD0 within the appropriate
- * 4KB-aligned region of the INST_ADDRESS space.
+ * Map real instruction number to the GDT selector of its TSS slot.
+ * -1 = exit (return to x86 TSS at selector 0x18).
  */
-static uint32_t inst_to_tss_addr(int inst_nr) {
-    switch (inst_nr % 3) {
-        case 0:  return INST_ADDRESS + 0x0ffd0;
-        case 1:  return INST_ADDRESS + 0x1ffd0;
-        default: return INST_ADDRESS + 0x2ffd0;
-    }
+static uint32_t inst_to_tss_selector(struct wm_ctx *w, int inst_nr) {
+    if (inst_nr < 0) return 0x18;   /* Exit: x86 kernel TSS */
+    return slot_selector(w->insts[inst_nr].slot);
+}
+
+/* Map real instruction number to its TSS virtual address */
+static uint32_t inst_to_tss_addr(struct wm_ctx *w, int inst_nr) {
+    return slot_tss_addr(w->insts[inst_nr].slot);
 }
 
 /* ========== Register Setup ========== */
@@ -174,8 +380,8 @@ static uint32_t inst_to_tss_addr(int inst_nr) {
  * The register value is stored in the ESP field of the TSS,
  * shifted left by 2 (because error code push decrements ESP by 4).
  */
-static void gen_reg(int reg_page, uint32_t value) {
-    uint32_t *p = PAGE2VIRT(reg_page);
+static void gen_reg(struct wm_ctx *w, int reg_page, uint32_t value) {
+    uint32_t *p = PAGE2VIRT(w, reg_page);
     memset32(p, 0, 1024);
 
     /* These are TSS fields at the tail end of the structure:
@@ -199,46 +405,57 @@ static void gen_reg(int reg_page, uint32_t value) {
  * Generate a page directory for one instruction.
  * Maps: stack, instruction/IDT range, kernel code, GDT.
  */
-static void generate_pagetable(uint32_t pd_page) {
-    uint32_t *pde = PAGE2VIRT(pd_page);
+static void generate_pagetable(struct wm_ctx *w, uint32_t pd_page) {
+    uint32_t *pde = PAGE2VIRT(w, pd_page);
     memset32(pde, 0, 1024);
 
     /* PDE[0]: Stack at 0x00000000 */
-    uint32_t *pt_stack = PAGE2VIRT(STACK_PT_PAGE);
-    pt_stack[0] = PG_P | PG_W | ((PROG_BASE_PAGE + STACK_PAGE) << 12);
-    pde[0] = PG_P | PG_W | ((PROG_BASE_PAGE + STACK_PT_PAGE) << 12);
+    uint32_t *pt_stack = PAGE2VIRT(w, STACK_PT_PAGE);
+    pt_stack[0] = PG_P | PG_W | PAGE2PHYS(w, STACK_PAGE);
+    pde[0] = PG_P | PG_W | PAGE2PHYS(w, STACK_PT_PAGE);
 
-    /* PDE[1]: Instruction + IDT at 0x00400000 */
-    uint32_t *pt_inst = PAGE2VIRT(pd_page + INST_PT_OFF);
-    pt_inst[0] = PG_P | PG_W | ((PROG_BASE_PAGE + pd_page + IDT_OFF) << 12);
-    pde[1] = PG_P | PG_W | ((PROG_BASE_PAGE + pd_page + INST_PT_OFF) << 12);
+    /* PDE[1]: Instruction + IDT at 0x00400000 (IDT mapped by caller) */
+    pde[1] = PG_P | PG_W | PAGE2PHYS(w, pd_page + INST_PT_OFF);
 
     /* PDE[3]: Kernel code at 0x00C00000 (4MB identity map) */
-    pde[3] = PG_P | PG_PS | PG_W | (3 << 22);
-
-    /* PDE[6]: GDT at 0x01800000 */
-    uint32_t *pt_gdt = PAGE2VIRT(GDT_PT_PAGE);
-    for (int i = 0; i < 4; i++)
-        pt_gdt[i] = PG_P | PG_W | ((PROG_BASE_PAGE + GDT_PAGE0 + i) << 12);
-    pde[6] = PG_P | PG_W | ((PROG_BASE_PAGE + GDT_PT_PAGE) << 12);
-
-    /* PDE for PROG_BASE_ADDR: identity map program pages (4MB) */
-    pde[PROG_BASE_ADDR >> 22] = PG_P | PG_PS | PG_W | (PROG_BASE_ADDR);
+    pde[X86_BASE_ADDRESS >> 22] = PG_P | PG_PS | PG_W | PG_SHARED | X86_BASE_ADDRESS;
+
+    /* PDE[2]: GDT at 0x00800000, in the instance's window */
+    uint32_t *pt_gdt = PAGE2VIRT(w, GDT_PT_PAGE);
+    for (int i = 0; i < GDT_PAGES; i++)
+        pt_gdt[w->index * (GDT_WINDOW >> 12) + i] = PG_P | PG_W | PAGE2PHYS(w, GDT_PAGE0 + i);
+    pde[GDT_ADDRESS >> 22] = PG_P | PG_W | PAGE2PHYS(w, GDT_PT_PAGE);
+
+    /* PDEs for the program region: identity map the 4MB pages it spans.
+     * Instance 0 maps the span of a full region whatever wm_setup() gave
+     * it, so its pages match prebuilt images on any RAM size. */
+    uint32_t span = w->index == 0 ? FULL_REGION_PAGES << 12 : w->pages << 12;
+    for (uint32_t i = w->base >> 22; i <= (w->base + span - 1) >> 22; i++)
+        pde[i] = PG_P | PG_PS | PG_W | PG_SHARED | (i << 22);
 }
 
 /*
- * Generate the IDT page for one instruction.
- * Sets up task gates for #PF (vector 14) and #DF (vector 8).
+ * Get the IDT page for a pair of branch targets, generating it on first use.
+ * Sets up task gates for #PF (vector 14) and #DF (vector 8). Only the
+ * target's TSS selector ends up in the page, so every instruction with
+ * the same selector pair (e.g. all exits) shares one read-only page.
  */
-static void generate_idt_page(uint32_t pd_page,
-                               int dest_pf_inst,    /* #PF target (nonzero) */
-                               int dest_df_inst)    /* #DF target (zero) */
+static uint32_t intern_idt_page(struct wm_ctx *w, int dest_pf_inst,    /* #PF target (nonzero) */
+                                int dest_df_inst)    /* #DF target (zero) */
 {
-    uint32_t *p = PAGE2VIRT(pd_page + IDT_OFF);
-    memset32(p, 0, 1024);
+    uint32_t tss_pf = inst_to_tss_selector(w, dest_pf_inst);
+    uint32_t tss_df = inst_to_tss_selector(w, dest_df_inst);
+    uint32_t key = (tss_pf << 16) | tss_df;
 
-    uint32_t tss_pf = inst_to_tss_selector(dest_pf_inst);
-    uint32_t tss_df = inst_to_tss_selector(dest_df_inst);
+    for (int i = 0; i < w->num_idt_pages; i++)
+        if (w->idt_page_key[i] == key)
+            return IDT_POOL_PAGE + i;
+
+    uint32_t idt_page = IDT_POOL_PAGE + w->num_idt_pages;
+    w->idt_page_key[w->num_idt_pages++] = key;
+
+    uint32_t *p = PAGE2VIRT(w, idt_page);
+    memset32(p, 0, 1024);
 
     /* IDT entry 8: Double Fault (#DF) - branch-if-zero path */
     p[16] = tss_df << 16;          /* TSS selector in upper 16 bits */
@@ -247,6 +464,14 @@ static void generate_idt_page(uint32_t pd_page,
     /* IDT entry 14: Page Fault (#PF) - branch-not-zero path */
     p[28] = tss_pf << 16;
     p[29] = 0xe500;
+
+    return idt_page;
+}
+
+/* Map an IDT page at IDT_ADDRESS in a page directory's INST_ADDRESS table */
+static void map_idt_page(struct wm_ctx *w, uint32_t pd_page, uint32_t idt_page) {
+    uint32_t *pt = PAGE2VIRT(w, pd_page + INST_PT_OFF);
+    pt[0] = PG_P | PG_W | PAGE2PHYS(w, idt_page);
 }
 
 /*
@@ -254,17 +479,17 @@ static void generate_idt_page(uint32_t pd_page,
  * Contains CR3, EIP (unmapped!), EFLAGS, and a fresh GDT descriptor
  * to clear the TSS busy bit.
  */
-static void generate_inst_page(uint32_t pd_page, int inst_nr) {
-    uint32_t *p = PAGE2VIRT(pd_page + INST_OFF);
+static void generate_inst_page(struct wm_ctx *w, uint32_t pd_page, int inst_nr) {
+    uint32_t *p = PAGE2VIRT(w, pd_page + INST_OFF);
     memset32(p, 0, 1024);
 
-    uint32_t tss_addr = inst_to_tss_addr(inst_nr);
+    uint32_t tss_addr = inst_to_tss_addr(w, inst_nr);
 
     /* TSS starts at offset 0xFD0 within this page (DWORD 1012).
      * Fields at the head of the TSS: */
-    p[1019] = (PROG_BASE_PAGE + pd_page) << 12;  /* CR3: this instruction's PD */
+    p[1019] = PAGE2PHYS(w, pd_page);  /* CR3: this instruction's PD */
     p[1020] = 0xfffefff;                           /* EIP: unmapped -> page fault! */
-    p[1021] = read_eflags();                       /* EFLAGS */
+    p[1021] = WM_TSS_EFLAGS;                       /* EFLAGS: no IRQs mid-cascade */
 
     /* Write a fresh TSS descriptor (busy bit clear) into the position
      * that the GDT maps to. This is the key trick: the GDT page is
@@ -277,56 +502,74 @@ static void generate_inst_page(uint32_t pd_page, int inst_nr) {
  * Map the destination TSS for this instruction.
  * The destination register page becomes the tail of the next instruction's TSS.
  */
-static void map_dest_tss(uint32_t pd_page, int inst_nr, int reg_page) {
-    uint32_t *pt = PAGE2VIRT(pd_page + INST_PT_OFF);
-    uint32_t tss_addr = inst_to_tss_addr(inst_nr);
-    uint32_t seg_descr = inst_to_tss_selector(inst_nr);
+static void map_dest_tss(struct wm_ctx *w, uint32_t pd_page, int inst_nr, int reg_page) {
+    uint32_t *pt = PAGE2VIRT(w, pd_page + INST_PT_OFF);
+    uint32_t tss_addr = inst_to_tss_addr(w, inst_nr);
+    uint32_t seg_descr = inst_to_tss_selector(w, inst_nr);
     uint32_t pt_idx = (tss_addr & 0x003ff000) >> 12;
 
     /* Map the GDT page containing this TSS's descriptor */
-    pt[pt_idx] = PG_P | PG_W | ((PROG_BASE_PAGE + GDT_PAGE0 + (seg_descr >> 12)) << 12);
+    pt[pt_idx] = PG_P | PG_W | PAGE2PHYS(w, GDT_PAGE0 + (seg_descr >> 12));
     /* Map the register page as the next page (TSS tail with ESP) */
-    pt[pt_idx + 1] = PG_P | PG_W | ((PROG_BASE_PAGE + reg_page) << 12);
+    pt[pt_idx + 1] = PG_P | PG_W | PAGE2PHYS(w, reg_page);
 }
 
 /*
  * Map the source TSS for the next instruction.
  * The instruction page becomes the head, source register page the tail.
  */
-static void map_src_tss(uint32_t pd_page, int next_inst_nr, int reg_page) {
-    uint32_t *pt = PAGE2VIRT(pd_page + INST_PT_OFF);
-    uint32_t tss_addr = inst_to_tss_addr(next_inst_nr);
-    uint32_t inst_off_page = first_inst_page + next_inst_nr * PAGES_PER_INST + INST_OFF;
+static void map_src_tss(struct wm_ctx *w, uint32_t pd_page, int next_inst_nr, int reg_page) {
+    uint32_t *pt = PAGE2VIRT(w, pd_page + INST_PT_OFF);
+    uint32_t tss_addr = inst_to_tss_addr(w, next_inst_nr);
+    uint32_t inst_off_page = w->first_inst_page + next_inst_nr * PAGES_PER_INST + INST_OFF;
     uint32_t pt_idx = (tss_addr & 0x003ff000) >> 12;
 
     /* Map the instruction page (TSS head with CR3, EIP, EFLAGS) */
-    pt[pt_idx] = PG_P | PG_W | ((PROG_BASE_PAGE + inst_off_page) << 12);
+    pt[pt_idx] = PG_P | PG_W | PAGE2PHYS(w, inst_off_page);
     /* Map the source register page (TSS tail with ESP = value) */
-    pt[pt_idx + 1] = PG_P | PG_W | ((PROG_BASE_PAGE + reg_page) << 12);
+    pt[pt_idx + 1] = PG_P | PG_W | PAGE2PHYS(w, reg_page);
 }
 
-/* ========== Instruction Generation ========== */
-
 /*
- * Generate one real instruction (internal).
- * Each movdbz assembly instruction expands to 3 real instructions.
+ * Generate the entry page directory for one movdbz instruction.
+ * Same mappings as an instruction PD, plus the entry NOP's source TSS
+ * so the launching ljmp can read it. Built once by wm_generate() so
+ * resuming never has to touch page tables.
  */
-static void gen_inst(int inst_nr,
-                     int dest_pf_inst, int dest_df_inst,
-                     int dest_reg_page,
-                     int pf_input_reg_page, int df_input_reg_page)
-{
-    uint32_t pd_page = first_inst_page + inst_nr * PAGES_PER_INST + PD_OFF;
+static void generate_entry_pd(struct wm_ctx *w, int asm_inst) {
+    uint32_t pd_page = w->first_entry_page + asm_inst * PAGES_PER_ENTRY + ENTRY_PD_OFF;
+    int entry = w->entry_inst[asm_inst];
+
+    generate_pagetable(w, pd_page);
 
-    generate_pagetable(pd_page);
-    generate_idt_page(pd_page, dest_pf_inst, dest_df_inst);
-    generate_inst_page(pd_page, inst_nr);
-    map_dest_tss(pd_page, inst_nr, dest_reg_page);
+    /* Point the IDT slot at the entry instruction's own IDT page */
+    uint32_t *pt = PAGE2VIRT(w, pd_page + INST_PT_OFF);
+    uint32_t *entry_pt = PAGE2VIRT(w, w->first_inst_page
+                                   + entry * PAGES_PER_INST + INST_PT_OFF);
+    pt[0] = entry_pt[0];
 
-    if (dest_pf_inst >= 0)
-        map_src_tss(pd_page, dest_pf_inst, pf_input_reg_page);
-    if (dest_df_inst >= 0)
-        map_src_tss(pd_page, dest_df_inst, df_input_reg_page);
+    map_src_tss(w, pd_page, entry, w->insts[entry].src_page);
+}
+
+/* ========== Instruction Generation ========== */
+
+/*
+ * Generate the pages of one real instruction from its insts[] entry.
+ * Entering a successor loads its source register page as the TSS tail.
+ */
+static void gen_inst(struct wm_ctx *w, int inst_nr) {
+    const struct real_inst *in = &w->insts[inst_nr];
+    uint32_t pd_page = w->first_inst_page + inst_nr * PAGES_PER_INST + PD_OFF;
+
+    generate_pagetable(w, pd_page);
+    map_idt_page(w, pd_page, intern_idt_page(w, in->nz, in->z));
+    generate_inst_page(w, pd_page, inst_nr);
+    map_dest_tss(w, pd_page, inst_nr, in->dest_page);
+
+    if (in->nz >= 0)
+        map_src_tss(w, pd_page, in->nz, w->insts[in->nz].src_page);
+    if (in->z >= 0 && in->z != in->nz)
+        map_src_tss(w, pd_page, in->z, w->insts[in->z].src_page);
 }
 
 /*
@@ -339,10 +582,135 @@ static int reg_to_page(int reg_nr) {
     return REG_R0_PAGE + reg_nr;
 }
 
+/* ========== TSS Slot Assignment ========== */
+
+/*
+ * Switching from one real instruction to the next only works if their
+ * TSS slots differ (the outgoing task is still busy, and its slot's
+ * pages map the destination register) and if the two successors of an
+ * instruction differ from each other (both are mapped as sources). A
+ * movdbz reached through #DF must also not fault pushing the error code,
+ * which would be a triple fault, so it has to read a nonzero constant.
+ *
+ * Slots are colored over the control-flow graph and a NOP (read the
+ * constant one, write discard, continue at the target) is inserted only
+ * on branches that still violate one of these. Every movdbz also gets
+ * an entry NOP for wm_resume(), since the launching ljmp pushes nothing.
+ */
+
+#define SLOT_BIT(w, inst_nr)  (1u << (w)->insts[inst_nr].slot)
+
+/* Does movdbz m read a register that is never written and not zero? */
+static int src_nonzero(struct wm_ctx *w, int m) {
+    int src = w->movdbz[m].src;
+    for (int i = 0; i < w->num_asm_insts; i++)
+        if (w->movdbz[i].dest == src)
+            return 0;
+    if (src == WM_REG_CONST_ONE)
+        return 1;
+    for (int i = 0; i < w->num_const_regs; i++)
+        if (w->const_reg[i] == src)
+            return w->const_value[i] != 0;
+    return 0;
+}
+
+/* Get a NOP that continues at real instruction `target` and whose slot
+ * is not in `forbid`, sharing an existing one when possible */
+static int nop_to(struct wm_ctx *w, int target, uint32_t forbid) {
+    forbid |= SLOT_BIT(w, target);
+    for (int i = w->num_asm_insts; i < w->num_real_insts; i++)
+        if (w->insts[i].nz == target && !(forbid & SLOT_BIT(w, i)))
+            return i;
+
+    /* At most three slots are forbidden, so this always finds one */
+    int slot = 0;
+    while (forbid & (1u << slot))
+        slot++;
+
+    struct real_inst *nop = &w->insts[w->num_real_insts];
+    nop->nz = nop->z = (int16_t)target;
+    nop->dest_page = REG_DISCARD_PAGE;
+    nop->src_page = REG_CONST_ONE_PAGE;
+    nop->slot = (uint8_t)slot;
+    return w->num_real_insts++;
+}
+
+/* Movdbz i's branch target if it can be taken without a NOP given the
+ * right slots, else -1 */
+static int direct_target(struct wm_ctx *w, int i, int zero) {
+    int t = zero ? w->movdbz[i].z : w->movdbz[i].nz;
+    if (t < 0 || t == i || (zero && !src_nonzero(w, t)))
+        return -1;
+    return t;
+}
+
+/* Point movdbz i's branches at their targets: direct when the slots
+ * allow it, else via a NOP */
+static void resolve_branches(struct wm_ctx *w, int i) {
+    int t_nz = w->movdbz[i].nz, t_z = w->movdbz[i].z;
+    int d_nz = direct_target(w, i, 0), d_z = direct_target(w, i, 1);
+    int nz = t_nz < 0 ? -1 : -2;    /* -2: needs a NOP */
+    int z = t_z < 0 ? -1 : -2;
+
+    if (d_nz >= 0 && w->insts[d_nz].slot != w->insts[i].slot)
+        nz = d_nz;
+    if (d_z >= 0 && w->insts[d_z].slot != w->insts[i].slot)
+        z = d_z;
+    if (nz >= 0 && z >= 0 && nz != z && w->insts[nz].slot == w->insts[z].slot)
+        z = -2;
+
+    if (nz == -2)
+        nz = nop_to(w, t_nz, SLOT_BIT(w, i) | (z >= 0 ? SLOT_BIT(w, z) : 0));
+    if (z == -2)
+        z = (t_z == t_nz && nz >= w->num_asm_insts) ? nz
+            : nop_to(w, t_z, SLOT_BIT(w, i) | (nz >= 0 ? SLOT_BIT(w, nz) : 0));
+
+    w->insts[i].nz = (int16_t)nz;
+    w->insts[i].z = (int16_t)z;
+}
+
+static void assign_slots(struct wm_ctx *w) {
+    int n = w->num_asm_insts;
+    int16_t dnz[MAX_ASM_INSTS], dz[MAX_ASM_INSTS];
+
+    for (int i = 0; i < n; i++) {
+        dnz[i] = (int16_t)direct_target(w, i, 0);
+        dz[i] = (int16_t)direct_target(w, i, 1);
+    }
+
+    /* Greedy coloring in program order. When every slot is taken the
+     * last one is used and the resulting conflicts get NOPs below. */
+    for (int i = 0; i < n; i++) {
+        uint32_t used = 0;
+        for (int k = 0; k < i; k++)
+            if (dnz[i] == k || dz[i] == k || dnz[k] == i || dz[k] == i)
+                used |= SLOT_BIT(w, k);
+        for (int k = 0; k < n; k++) {
+            int other = dnz[k] == i ? dz[k] : dz[k] == i ? dnz[k] : -1;
+            if (other >= 0 && other < i)
+                used |= SLOT_BIT(w, other);
+        }
+        int slot = 0;
+        while (slot < WM_TSS_SLOTS - 1 && (used & (1u << slot)))
+            slot++;
+        w->insts[i].slot = (uint8_t)slot;
+    }
+
+    w->num_real_insts = n;
+    for (int i = 0; i < n; i++) {
+        w->insts[i].dest_page = (int16_t)reg_to_page(w->movdbz[i].dest);
+        w->insts[i].src_page = (int16_t)reg_to_page(w->movdbz[i].src);
+        resolve_branches(w, i);
+    }
+
+    for (int i = 0; i < n; i++)
+        w->entry_inst[i] = (int16_t)nop_to(w, i, 0);
+}
+
 /* ========== GDT and TSS Setup ========== */
 
-static void init_gdt(uint32_t *gdt) {
-    memset32(gdt, 0, 4096);  /* 4 pages * 1024 DWORDs = 16KB */
+static void init_gdt(struct wm_ctx *w, uint32_t *gdt) {
+    memset32(gdt, 0, GDT_PAGES * 1024);
 
     /* Null descriptor at index 0 */
     /* Selector 0x08: Code segment (ring 0, flat) */
@@ -350,34 +718,76 @@ static void init_gdt(uint32_t *gdt) {
     /* Selector 0x10: Data segment (ring 0, flat) */
     encode_seg_descr(&gdt[4], 0x92, 1, 0, 0xfffff);
     /* Selector 0x18: x86 kernel TSS (for returning from weird machine) */
-    encode_seg_descr(&gdt[6], 0x89, 0, (uint32_t)x86_tss, 0x67);
+    encode_seg_descr(&gdt[6], 0x89, 0, X86_TSS_ADDR(w), 0x67);
+
+    /* One TSS slot at the end of each following GDT page */
+    for (int s = 0; s < WM_TSS_SLOTS; s++)
+        encode_seg_descr(&gdt[slot_selector(s) >> 2], 0x89, 0, slot_tss_addr(s), 0x67);
+}
 
-    /* Three rotating TSS slots at the end of GDT pages 0, 1, 2 */
-    encode_seg_descr(&gdt[0x7fe], 0x89, 0, 0x40ffd0, 0x67);   /* Selector 0x1FF8 */
-    encode_seg_descr(&gdt[0xbfe], 0x89, 0, 0x41ffd0, 0x67);   /* Selector 0x2FF8 */
-    encode_seg_descr(&gdt[0xffe], 0x89, 0, 0x42ffd0, 0x67);   /* Selector 0x3FF8 */
+#ifndef WM_HOSTGEN
+
+/*
+ * Clear the busy bits left behind by a cascade: the TSS slots and the
+ * x86 kernel TSS (set by the exit task switch). Everything else in the
+ * GDT is untouched by the weird machine.
+ */
+static void clear_tss_busy(uint32_t *gdt) {
+    gdt[0x007] &= ~TSS_BUSY;    /* Selector 0x18 */
+    for (int s = 0; s < WM_TSS_SLOTS; s++)
+        gdt[(slot_selector(s) >> 2) + 1] &= ~TSS_BUSY;
 }
 
-static void init_tss(void) {
+static void init_tss(struct wm_ctx *w) {
+    uint32_t *tss = x86_tss[w->index];
     for (int i = 0; i < 26; i++)
-        x86_tss[i] = 0;
-    x86_tss[7] = X86_PD_ADDRESS;   /* CR3: kernel's page directory */
+        tss[i] = 0;
+    tss[7] = X86_PD_ADDRESS;   /* CR3: kernel's page directory */
 }
 
 /* ========== Initial Paging ========== */
 
 /*
- * Set up the initial x86 page directory.
- * Identity maps the first 2GB using 4MB pages (PSE).
+ * Set up the initial x86 page directory: 4MB identity maps (PSE) of low
+ * memory, the kernel and every instance's program region (PROG_BASE_ADDR
+ * up to region_end), and the GDT
+ * windows. Nothing else is mapped; see wm_map_mmio() for devices. The
+ * entries shared with the instruction page directories carry the same
+ * global flag.
  */
 static void init_x86_paging(void) {
-    uint32_t *pde = (uint32_t *)X86_PD_ADDRESS;
-    for (int i = 0; i < 512; i++)
-        pde[i] = PG_P | PG_PS | PG_W | ((uint32_t)i << 22);
+    uint32_t *pde = x86_pd;
+    memset32(pde, 0, 1024);
+    pde[0] = PG_P | PG_PS | PG_W;
+    pde[X86_BASE_ADDRESS >> 22] = PG_P | PG_PS | PG_W | PG_SHARED | X86_BASE_ADDRESS;
+    for (uint32_t i = PROG_BASE_ADDR >> 22;
+         i <= (region_end - 1) >> 22; i++)
+        pde[i] = PG_P | PG_PS | PG_W | PG_SHARED | (i << 22);
+
+    /* Each instance's GDT window maps its normal-mode GDT, as its
+     * instruction page directories map the program GDT pages there */
+    for (int cpu = 0; cpu < WM_MAX_CPUS; cpu++)
+        for (int i = 0; i < GDT_PAGES; i++)
+            x86_gdt_pt[cpu * (GDT_WINDOW >> 12) + i] =
+                PG_P | PG_W | ((uint32_t)x86_gdt[cpu] + ((uint32_t)i << 12));
+    pde[GDT_ADDRESS >> 22] = PG_P | PG_W | (uint32_t)x86_gdt_pt;
+}
 
+/* Turn paging on over the x86 page directory (once per CPU) */
+static void enable_paging(void) {
     write_cr3(X86_PD_ADDRESS);
-    write_cr4(read_cr4() | 0x10);       /* Enable PSE */
+    write_cr4(read_cr4() | CR4_PSE);    /* Enable PSE */
     write_cr0(read_cr0() | (1u << 31)); /* Enable paging */
+#if WM_GLOBAL_PAGES
+    write_cr4(read_cr4() | CR4_PGE);    /* Enable global pages */
+#endif
+}
+
+void wm_map_mmio(uint32_t base, uint32_t size) {
+    uint32_t *pde = x86_pd;
+    for (uint32_t i = base >> 22; i <= (base + size - 1) >> 22; i++)
+        pde[i] = PG_P | PG_PS | PG_W | (i << 22);
+    write_cr3(X86_PD_ADDRESS);
 }
 
 /* ========== External Assembly: Load GDT and TR ========== */
@@ -395,167 +805,496 @@ static void set_idtr(uint32_t base_addr, uint16_t table_limit) {
     __asm__ volatile ("lidtl %0" : : "m"(idtr) : "memory");
 }
 
+#endif /* !WM_HOSTGEN */
+
 /* ========== Public API ========== */
 
-void wm_setup(void) {
-    /* Enable paging with identity mapping */
+#ifndef WM_HOSTGEN
+
+int wm_setup(uint32_t mem_end) {
+    /* Instance 0 takes what the other regions leave, up to a full one */
+    uint32_t ap_regions = (WM_MAX_CPUS - 1) * AP_REGION_SIZE;
+    mem_end &= ~0xfffu;
+    if (mem_end < PROG_BASE_ADDR + ap_regions + AP_REGION_SIZE)
+        return -1;
+    uint32_t pages = (mem_end - PROG_BASE_ADDR - ap_regions) >> 12;
+    if (pages > FULL_REGION_PAGES)
+        pages = FULL_REGION_PAGES;
+    ctxs[0].pages = pages;
+    region_end = PROG_BASE_ADDR + (pages << 12) + ap_regions;
+
+    /* Build the identity mapping shared by all CPUs */
     init_x86_paging();
+    wm_setup_cpu(0);
+    return 0;
+}
+
+void wm_setup_cpu(int cpu) {
+    if (cpu < 0 || cpu >= WM_MAX_CPUS)
+        return;
+    struct wm_ctx *w = &ctxs[cpu];
+    w->index = cpu;
+    if (cpu == 0) {
+        w->base = PROG_BASE_ADDR;       /* Size set by wm_setup() */
+    } else {
+        w->base = region_end - (uint32_t)cpu * AP_REGION_SIZE;
+        w->pages = WM_REGION_PAGES;
+    }
+
+    /* Enable paging with identity mapping */
+    enable_paging();
 
     /* Initialize TSS for returning from weird machine */
-    init_tss();
+    init_tss(w);
 
-    /* Initialize GDT at physical GDT_ADDRESS (accessible under identity mapping).
-     * This is needed because set_gdtr/lgdt reads from this address before
-     * we switch to the weird machine's page directories. */
-    init_gdt((uint32_t *)GDT_ADDRESS);
+    /* Initialize the normal-mode GDT at GDT_ADDR(w) (x86_gdt[] through
+     * the GDT window). This is needed because set_gdtr/lgdt reads from
+     * this address before we switch to the weird machine's page
+     * directories. */
+    init_gdt(w, (uint32_t *)GDT_ADDR(w));
 
     /* Load GDTR and Task Register */
-    set_gdtr(4 * 4096 - 1, GDT_ADDRESS);
+    set_gdtr(GDT_PAGES * 4096 - 1, GDT_ADDR(w));
 
     /* Load IDTR - the IDT is mapped at IDT_ADDRESS (= INST_ADDRESS = 0x00400000)
      * in each instruction's page directory */
     set_idtr(IDT_ADDRESS, 0x7ff);
 
+    wm_reset();
+}
+
+#endif /* !WM_HOSTGEN */
+
+void wm_reset(void) {
+    struct wm_ctx *w = self();
     /* Set default register/instruction counts */
-    num_user_regs = 0;
-    num_const_regs = 0;
-    num_asm_insts = 0;
+    w->num_user_regs = 0;
+    w->num_const_regs = 0;
+    w->num_asm_insts = 0;
+    w->num_real_insts = 0;
+    w->num_idt_pages = 0;
+    w->fuel_reg = -1;
+    w->fuel_budget = 0;
+    w->fuel_insts = 0;
 }
 
-void wm_write_reg(int reg_nr, uint32_t value) {
-    int page;
-    if (reg_nr >= 0) {
-        page = REG_R0_PAGE + reg_nr;
-        if (reg_nr >= num_user_regs)
-            num_user_regs = reg_nr + 1;
-    } else {
-        return;  /* Can't write to special regs this way */
+int wm_write_reg(int reg_nr, uint32_t value) {
+    struct wm_ctx *w = self();
+    if (reg_nr < 0 || reg_nr >= MAX_REGISTERS)
+        return -1;  /* Can't write to special regs this way */
+
+    /* Fast path: the page is set up, only the ESP dword changes */
+    if (reg_nr < w->num_user_regs) {
+        PAGE2VIRT(w, REG_R0_PAGE + reg_nr)[2] = value << 2;
+        return 0;
     }
-    gen_reg(page, value);
+
+    /* New registers would overlap the constants allocated above them */
+    if (w->num_const_regs)
+        return -1;
+    while (w->num_user_regs < reg_nr)
+        gen_reg(w, REG_R0_PAGE + w->num_user_regs++, 0);
+    gen_reg(w, REG_R0_PAGE + w->num_user_regs++, value);
+    return 0;
 }
 
 uint32_t wm_read_reg(int reg_nr) {
+    struct wm_ctx *w = self();
     int page = REG_R0_PAGE + reg_nr;
-    uint32_t val = *(PAGE2VIRT(page) + 2);
+    uint32_t val = *(PAGE2VIRT(w, page) + 2);
     return val >> 2;
 }
 
+int wm_write_regs(int first_reg, const uint32_t *values, int count) {
+    struct wm_ctx *w = self();
+    if (first_reg >= 0 && first_reg + count <= w->num_user_regs) {
+        for (int i = 0; i < count; i++)
+            PAGE2VIRT(w, REG_R0_PAGE + first_reg + i)[2] = values[i] << 2;
+        return 0;
+    }
+    for (int i = 0; i < count; i++)
+        if (wm_write_reg(first_reg + i, values[i]) != 0)
+            return -1;
+    return 0;
+}
+
+void wm_read_regs(int first_reg, uint32_t *values, int count) {
+    struct wm_ctx *w = self();
+    for (int i = 0; i < count; i++)
+        values[i] = PAGE2VIRT(w, REG_R0_PAGE + first_reg + i)[2] >> 2;
+}
+
 int wm_alloc_const(uint32_t value) {
-    int reg_nr = num_user_regs + num_const_regs;
+    struct wm_ctx *w = self();
+    /* The built-in constant-one register already holds 1 */
+    if (value == 1)
+        return WM_REG_CONST_ONE;
+
+    /* Share an existing constant register with the same value */
+    for (int i = 0; i < w->num_const_regs; i++)
+        if (w->const_value[i] == value)
+            return w->const_reg[i];
+
+    int reg_nr = w->num_user_regs + w->num_const_regs;
+    if (reg_nr >= MAX_REGISTERS)
+        return -1;  /* Out of register pages */
     int page = REG_R0_PAGE + reg_nr;
-    gen_reg(page, value);
-    num_const_regs++;
+    gen_reg(w, page, value);
+    w->const_value[w->num_const_regs] = value;
+    w->const_reg[w->num_const_regs] = reg_nr;
+    w->num_const_regs++;
     return reg_nr;
 }
 
+/* A register operand is a special register or an allocated register */
+static int reg_valid(struct wm_ctx *w, int reg_nr) {
+    if (reg_nr == WM_REG_DISCARD || reg_nr == WM_REG_CONST_ONE) return 1;
+    return reg_nr >= 0 && reg_nr < w->num_user_regs + w->num_const_regs;
+}
+
 void wm_gen_movdbz(int asm_inst, int dest_reg, int src_reg, int dest_nz, int dest_z) {
-    /* Calculate first_inst_page based on current register allocation */
-    first_inst_page = REG_R0_PAGE + num_user_regs + num_const_regs;
+    struct wm_ctx *w = self();
+    /* Reject anything that would write outside the program region */
+    if (asm_inst < 0 || asm_inst >= MAX_ASM_INSTS)
+        return;
+    if (dest_nz >= MAX_ASM_INSTS || dest_z >= MAX_ASM_INSTS)
+        return;
+    if (!reg_valid(w, dest_reg) || !reg_valid(w, src_reg))
+        return;
+
+    /* Instructions skipped over exit */
+    while (w->num_asm_insts < asm_inst) {
+        struct wm_inst *gap = &w->movdbz[w->num_asm_insts++];
+        gap->dest = WM_REG_DISCARD;
+        gap->src = WM_REG_CONST_ONE;
+        gap->nz = gap->z = -1;
+    }
 
-    int dest_page = reg_to_page(dest_reg);
-    int src_page = reg_to_page(src_reg);
+    /* Pages are only laid out by wm_generate(), once every branch
+     * target is known */
+    struct wm_inst *in = &w->movdbz[asm_inst];
+    in->dest = (int16_t)dest_reg;
+    in->src = (int16_t)src_reg;
+    in->nz = (int16_t)dest_nz;
+    in->z = (int16_t)dest_z;
 
-    int i = asm_inst * 3;   /* Real instruction base number */
+    if (asm_inst >= w->num_asm_insts)
+        w->num_asm_insts = asm_inst + 1;
+}
 
-    /* NOP 0: read source, write to discard, both paths -> real inst */
-    gen_inst(i, i + 2, i + 2, REG_DISCARD_PAGE, src_page, src_page);
+int wm_generate(void) {
+    struct wm_ctx *w = self();
+    /* Initialize special registers */
+    gen_reg(w, REG_CONST_ONE_PAGE, 1);
+    gen_reg(w, REG_DISCARD_PAGE, 0);
 
-    /* NOP 1: same as NOP 0 (needed for TSS rotation) */
-    gen_inst(i + 1, i + 2, i + 2, REG_DISCARD_PAGE, src_page, src_page);
+    /* Entry page directories, then instructions */
+    w->first_entry_page = REG_R0_PAGE + w->num_user_regs + w->num_const_regs;
+    w->first_inst_page = w->first_entry_page + w->num_asm_insts * PAGES_PER_ENTRY;
 
-    /* REAL: read const_one, write to dest, branch to targets */
-    int real_dest_nz = (dest_nz < 0) ? -1 : dest_nz * 3;
-    int real_dest_z  = (dest_z < 0)  ? -1 : dest_z * 3 + 1;
+    /* Initialize program GDT pages */
+    init_gdt(w, PAGE2VIRT(w, GDT_PAGE0));
 
-    gen_inst(i + 2, real_dest_nz, real_dest_z,
-             dest_page, REG_CONST_ONE_PAGE, REG_CONST_ONE_PAGE);
+    assign_slots(w);
+    if (image_pages(w) > w->pages) {
+        w->num_asm_insts = w->num_real_insts = 0;   /* Nothing to launch */
+        return -1;
+    }
+    for (int i = 0; i < w->num_real_insts; i++)
+        gen_inst(w, i);
 
-    if (asm_inst >= num_asm_insts)
-        num_asm_insts = asm_inst + 1;
+    /* Precompute one entry page directory per resumable instruction */
+    for (int i = 0; i < w->num_asm_insts; i++)
+        generate_entry_pd(w, i);
+    return 0;
 }
 
-void wm_run(void) {
-    /* Initialize special registers */
-    gen_reg(REG_CONST_ONE_PAGE, 1);
-    gen_reg(REG_DISCARD_PAGE, 0);
+/*
+ * A patched branch of a fuel program must not bypass the checks
+ * thread_fuel() added: a backward target t goes through F_t, and the
+ * checks themselves are no target. Returns the target to install, or -2
+ * when there is none that keeps the loop metered.
+ */
+static int fuel_target(const struct wm_ctx *w, int asm_inst, int t) {
+    if (w->fuel_reg < 0 || t < 0)
+        return t;
+    if (t >= w->fuel_insts)
+        return -2;
+    if (t > asm_inst)
+        return t;
+    for (int f = w->fuel_insts + 1; f < w->num_asm_insts; f += 2)
+        if (w->movdbz[f].nz == t)
+            return f;
+    return -2;  /* No loop went back to t when the program was loaded */
+}
 
-    /* Finalize first_inst_page */
-    first_inst_page = REG_R0_PAGE + num_user_regs + num_const_regs;
+int wm_patch_branch(int asm_inst, int dest_nz, int dest_z) {
+    struct wm_ctx *w = self();
+    if (asm_inst < 0 || asm_inst >= w->num_asm_insts)
+        return -1;
+    if (dest_nz >= w->num_asm_insts || dest_z >= w->num_asm_insts)
+        return -1;
+    if (w->fuel_reg >= 0) {
+        if (asm_inst >= w->fuel_insts)
+            return -1;
+        dest_nz = fuel_target(w, asm_inst, dest_nz);
+        dest_z = fuel_target(w, asm_inst, dest_z);
+        if (dest_nz == -2 || dest_z == -2)
+            return -1;
+    }
+    if (w->num_real_insts + 2 > MAX_REAL_INSTS
+        || image_pages(w) + 2 * PAGES_PER_INST > w->pages)
+        return -1;  /* No room for the NOPs this may need */
+
+    struct real_inst *in = &w->insts[asm_inst];
+    uint32_t pd_page = w->first_inst_page + asm_inst * PAGES_PER_INST + PD_OFF;
+    uint32_t *pt = PAGE2VIRT(w, pd_page + INST_PT_OFF);
+    int first_new = w->num_real_insts;
+
+    /* Unmap the old successors' TSSs */
+    int old[2] = { in->nz, in->z };
+    for (int k = 0; k < 2; k++) {
+        if (old[k] < 0) continue;
+        uint32_t pt_idx = (inst_to_tss_addr(w, old[k]) & 0x003ff000) >> 12;
+        pt[pt_idx] = pt[pt_idx + 1] = 0;
+    }
 
-    /* Set up the initial page directory using the same function as
-     * real instructions. This maps stack, IDT, kernel, and GDT. */
-    generate_pagetable(INIT_PD);
+    w->movdbz[asm_inst].nz = (int16_t)(dest_nz < 0 ? -1 : dest_nz);
+    w->movdbz[asm_inst].z = (int16_t)(dest_z < 0 ? -1 : dest_z);
+    resolve_branches(w, asm_inst);
+    for (int i = first_new; i < w->num_real_insts; i++)
+        gen_inst(w, i);
+
+    /* New gates (an interned IDT page) and source TSSs */
+    map_idt_page(w, pd_page, intern_idt_page(w, in->nz, in->z));
+    if (in->nz >= 0)
+        map_src_tss(w, pd_page, in->nz, w->insts[in->nz].src_page);
+    if (in->z >= 0 && in->z != in->nz)
+        map_src_tss(w, pd_page, in->z, w->insts[in->z].src_page);
+    return 0;
+}
 
-    /* Map the first instruction's source TSS into the initial PD's
-     * page table so the ljmp can read it. */
-    map_src_tss(INIT_PD, 0, REG_CONST_ONE_PAGE);
+int wm_branch_switches(int asm_inst, int zero) {
+    struct wm_ctx *w = self();
+    if (asm_inst < 0 || asm_inst >= w->num_asm_insts)
+        return 0;
+    int next = zero ? w->insts[asm_inst].z : w->insts[asm_inst].nz;
+    return next >= w->num_asm_insts ? 2 : 1;
+}
 
-    /* Initialize program GDT pages with the same descriptors.
-     * These are what the weird machine sees via per-instruction
-     * page directories (which map GDT_ADDRESS to program GDT pages). */
-    init_gdt(PAGE2VIRT(GDT_PAGE0));
+/*
+ * Route every backward branch (the only way to loop) of the first n
+ * instructions through a fuel check per target t:
+ *   F_t: movdbz fuel, fuel, t, X_t
+ *   X_t: movdbz target, =t, Y, Y
+ *   Y:   movdbz cmd, =WM_IO_OUT_OF_FUEL, EXIT, EXIT
+ */
+static int thread_fuel(struct wm_ctx *w, int n, int cmd_reg) {
+    int16_t check[MAX_ASM_INSTS];
+    int c_cmd = wm_alloc_const(WM_IO_OUT_OF_FUEL + 1);
+    int next = n + 1;
+
+    if (c_cmd == -1 || next > MAX_ASM_INSTS)
+        return -1;
+    for (int t = 0; t < n; t++)
+        check[t] = -1;
+    wm_gen_movdbz(n, cmd_reg, c_cmd, -1, -1);
+
+    for (int i = 0; i < n; i++) {
+        int16_t *br[2] = { &w->movdbz[i].nz, &w->movdbz[i].z };
+        for (int k = 0; k < 2; k++) {
+            int t = *br[k];
+            if (t < 0 || t > i)
+                continue;
+            if (check[t] < 0) {
+                int c_t = wm_alloc_const((uint32_t)t + 1);
+                if (c_t == -1 || next + 2 > MAX_ASM_INSTS)
+                    return -1;
+                wm_gen_movdbz(next, w->fuel_reg, w->fuel_reg, t, next + 1);
+                wm_gen_movdbz(next + 1, w->fuel_reg + 1, c_t, n, n);
+                check[t] = (int16_t)next;
+                next += 2;
+            }
+            *br[k] = check[t];
+        }
+    }
+    return 0;
+}
 
-    /* Switch to initial page directory and launch the fault cascade.
-     * Under INIT_PD, GDT_ADDRESS maps to the program GDT pages. */
-    write_cr3((PROG_BASE_PAGE + INIT_PD) << 12);
+int wm_load_program(const struct wm_program *prog) {
+    int creg[MAX_REGISTERS];
+    int fuel_regs = prog->fuel ? 2 : 0;
+
+    if (prog->num_regs < 0 || prog->num_consts < 0 ||
+        prog->num_regs + fuel_regs + prog->num_consts > MAX_REGISTERS ||
+        prog->num_insts <= 0 || prog->num_insts > MAX_ASM_INSTS)
+        return -1;
+    if (prog->fuel && (prog->fuel > 1023 ||
+                       prog->cmd_reg < 0 || prog->cmd_reg >= prog->num_regs))
+        return -1;
+
+    wm_reset();
+
+    /* User registers first: constants are allocated above them */
+    for (int r = 0; r < prog->num_regs + fuel_regs; r++)
+        wm_write_reg(r, 0);
+    if (prog->fuel) {
+        struct wm_ctx *w = self();
+        w->fuel_reg = prog->num_regs;
+        w->fuel_budget = prog->fuel;
+        w->fuel_insts = prog->num_insts;
+        wm_write_reg(w->fuel_reg, prog->fuel);
+    }
+    for (int i = 0; i < prog->num_consts; i++) {
+        creg[i] = wm_alloc_const(prog->consts[i]);
+        if (creg[i] == -1)
+            return -1;
+    }
 
-    /* ljmp to TSS selector 0x1FF8 triggers the first task switch.
-     * The CPU saves current state into x86_tss (selector 0x18).
-     * When the program exits, we resume here. */
-    __asm__ volatile (
-        "ljmp $0x1ff8, $0x0\n\t"
-        "addl $4, %%esp"        /* Clean up error code pushed by fault */
-        : : : "memory"
-    );
+    for (int i = 0; i < prog->num_insts; i++) {
+        int op[2] = { prog->insts[i].dest, prog->insts[i].src };
+        for (int k = 0; k < 2; k++) {
+            if (op[k] > WM_REG_CONST(0)) continue;
+            int c = WM_REG_CONST(0) - op[k];
+            if (c >= prog->num_consts)
+                return -1;
+            op[k] = creg[c];
+        }
+        wm_gen_movdbz(i, op[0], op[1], prog->insts[i].nz, prog->insts[i].z);
+    }
+    if (prog->fuel && thread_fuel(self(), prog->num_insts, prog->cmd_reg) != 0)
+        return -1;
 
-    /* Restore normal page directory */
-    write_cr3(X86_PD_ADDRESS);
+    return wm_generate();
 }
 
-void wm_generate(void) {
-    /* Initialize special registers */
-    gen_reg(REG_CONST_ONE_PAGE, 1);
-    gen_reg(REG_DISCARD_PAGE, 0);
-
-    /* Finalize first_inst_page */
-    first_inst_page = REG_R0_PAGE + num_user_regs + num_const_regs;
+int wm_fuel_target(void) {
+    struct wm_ctx *w = self();
+    if (w->fuel_reg < 0)
+        return -1;
+    return (int)wm_read_reg(w->fuel_reg + 1);
+}
 
-    /* Initialize program GDT pages */
-    init_gdt(PAGE2VIRT(GDT_PAGE0));
+/* ========== Prebuilt Program Images ========== */
+
+/* Engine state carried by an image, in save_state() order */
+#define WM_STATE_WORDS  (10 + 2 * MAX_REGISTERS + IDT_POOL_PAGES \
+                         + MAX_ASM_INSTS + 2 * MAX_REAL_INSTS)
+
+#ifdef WM_HOSTGEN
+static void save_state(struct wm_ctx *w, uint32_t *st) {
+    *st++ = w->num_user_regs;
+    *st++ = w->num_const_regs;
+    *st++ = w->num_asm_insts;
+    *st++ = w->num_real_insts;
+    *st++ = w->num_idt_pages;
+    *st++ = w->first_inst_page;
+    *st++ = w->first_entry_page;
+    *st++ = (uint32_t)w->fuel_reg;
+    *st++ = w->fuel_budget;
+    *st++ = (uint32_t)w->fuel_insts;
+    for (int i = 0; i < MAX_REGISTERS; i++) *st++ = w->const_value[i];
+    for (int i = 0; i < MAX_REGISTERS; i++) *st++ = w->const_reg[i];
+    for (int i = 0; i < IDT_POOL_PAGES; i++) *st++ = w->idt_page_key[i];
+    for (int i = 0; i < MAX_ASM_INSTS; i++) *st++ = (uint16_t)w->entry_inst[i];
+    for (int i = 0; i < MAX_REAL_INSTS; i++) {
+        const struct real_inst *in = &w->insts[i];
+        *st++ = (uint32_t)(in->nz + 1) | (uint32_t)(in->z + 1) << 12
+               | (uint32_t)in->slot << 24;
+        *st++ = (uint16_t)in->dest_page | (uint32_t)(uint16_t)in->src_page << 16;
+    }
+}
+#endif
+
+static void load_state(struct wm_ctx *w, const uint32_t *st) {
+    w->num_user_regs = *st++;
+    w->num_const_regs = *st++;
+    w->num_asm_insts = *st++;
+    w->num_real_insts = *st++;
+    w->num_idt_pages = *st++;
+    w->first_inst_page = *st++;
+    w->first_entry_page = *st++;
+    w->fuel_reg = (int)*st++;
+    w->fuel_budget = *st++;
+    w->fuel_insts = (int)*st++;
+    for (int i = 0; i < MAX_REGISTERS; i++) w->const_value[i] = *st++;
+    for (int i = 0; i < MAX_REGISTERS; i++) w->const_reg[i] = *st++;
+    for (int i = 0; i < IDT_POOL_PAGES; i++) w->idt_page_key[i] = *st++;
+    for (int i = 0; i < MAX_ASM_INSTS; i++) w->entry_inst[i] = (int16_t)*st++;
+    for (int i = 0; i < MAX_REAL_INSTS; i++, st += 2) {
+        struct real_inst *in = &w->insts[i];
+        in->nz = (int16_t)((st[0] & 0xfff) - 1);
+        in->z = (int16_t)(((st[0] >> 12) & 0xfff) - 1);
+        in->slot = (uint8_t)(st[0] >> 24);
+        in->dest_page = (int16_t)(st[1] & 0xffff);
+        in->src_page = (int16_t)(st[1] >> 16);
+    }
 }
 
-/*
- * Internal: launch the fault cascade starting at a given real instruction.
- * entry_real_inst: the real (expanded) instruction number.
- * src_reg_page: the register page to use as the source TSS for the first instruction.
- */
-static void launch_at(int entry_real_inst, int src_reg_page) {
-    /* Re-initialize the GDT at the physical address (needed because
-     * TSS busy bits may be set from a previous run) */
-    init_gdt((uint32_t *)GDT_ADDRESS);
+uint32_t wm_image_checksum(void) {
+    struct wm_ctx *w = self();
+    /* FNV-1a over the program's pages, one dword at a time */
+    const uint32_t *p = PAGE2VIRT(w, 0);
+    uint32_t n = image_pages(w) * 1024;
+    uint32_t h = 0x811c9dc5;
+    for (uint32_t i = 0; i < n; i++)
+        h = (h ^ p[i]) * 0x01000193;
+    return h;
+}
 
-    /* Re-initialize TSS for returning from weird machine */
-    init_tss();
+int wm_load_image(const struct wm_image *img) {
+    struct wm_ctx *w = self();
+    if (img->version != WM_IMAGE_VERSION || img->state_words != WM_STATE_WORDS)
+        return -1;
+    if (img->pages > w->pages)
+        return -1;
+#ifndef WM_HOSTGEN
+    if (w->index != 0 || (uint32_t)x86_tss != X86_TSS_ADDRESS)
+        return -1;      /* Our descriptors would not match the image's */
+#endif
+
+    memset32(PAGE2VIRT(w, 0), 0, img->pages * 1024);
+    for (const uint32_t *r = img->runs; r[1]; r += 2 + r[1]) {
+        uint32_t *dst = PAGE2VIRT(w, 0) + r[0];
+        for (uint32_t i = 0; i < r[1]; i++)
+            dst[i] = r[2 + i];
+    }
+    load_state(w, img->state);
+    return 0;
+}
 
-    /* Reload GDTR and TR (TR was left pointing at a weird machine TSS) */
-    set_gdtr(4 * 4096 - 1, GDT_ADDRESS);
+#ifndef WM_HOSTGEN
 
-    /* Reload IDTR */
-    set_idtr(IDT_ADDRESS, 0x7ff);
+/*
+ * Internal: launch the fault cascade at a given movdbz instruction.
+ * Uses the entry page directory precomputed by wm_generate().
+ *
+ * GDTR, IDTR and TR survive a cascade unchanged (the exit task switch
+ * leaves TR at 0x18), and the slot descriptors are rewritten by the
+ * cascade itself, so only the busy bits need clearing. Both GDT copies
+ * are cleared since the exit switch may mark 0x18 busy in either.
+ */
+static void launch_at(struct wm_ctx *w, int entry_asm_inst) {
+    uint64_t t0 = read_tsc();
 
-    /* Set up INIT_PD for the entry instruction */
-    generate_pagetable(INIT_PD);
-    map_src_tss(INIT_PD, entry_real_inst, src_reg_page);
+    /* No interrupts while the weird machine's IDT is loaded */
+    uint32_t flags = read_eflags();
+    __asm__ volatile ("cli");
+    if (w->host_idt_base)
+        set_idtr(IDT_ADDRESS, 0x7ff);
 
-    /* Refresh program GDT pages (clear busy bits) */
-    init_gdt(PAGE2VIRT(GDT_PAGE0));
+    clear_tss_busy((uint32_t *)GDT_ADDR(w));
+    clear_tss_busy(PAGE2VIRT(w, GDT_PAGE0));
+    if (w->fuel_reg >= 0)
+        PAGE2VIRT(w, REG_R0_PAGE + w->fuel_reg)[2] = w->fuel_budget << 2;
 
-    /* Switch to initial page directory */
-    write_cr3((PROG_BASE_PAGE + INIT_PD) << 12);
+    /* Switch to the entry page directory */
+    uint32_t pd_page = w->first_entry_page + entry_asm_inst * PAGES_PER_ENTRY + ENTRY_PD_OFF;
+    write_cr3(PAGE2PHYS(w, pd_page));
 
     /* Launch! Build a far pointer for the indirect ljmp.
-     * The selector depends on which TSS slot this instruction uses. */
-    uint32_t sel = inst_to_tss_selector(entry_real_inst);
+     * The selector depends on which TSS slot the entry NOP uses. */
+    uint32_t sel = inst_to_tss_selector(w, w->entry_inst[entry_asm_inst]);
     struct __attribute__((__packed__)) {
         uint32_t offset;
         uint16_t selector;
@@ -571,14 +1310,51 @@ static void launch_at(int entry_real_inst, int src_reg_page) {
 
     /* Restore normal page directory */
     write_cr3(X86_PD_ADDRESS);
+
+    /* Swap the normal-mode IDT back in before re-enabling interrupts.
+     * The exit task switch leaves NT set; clear it so no iret in normal
+     * mode is ever taken as a task return. */
+    if (w->host_idt_base)
+        set_idtr(w->host_idt_base, w->host_idt_limit);
+    write_eflags(flags & ~EFLAGS_NT);
+
+    w->last_cycles = read_tsc() - t0;
 }
 
 void wm_launch(void) {
-    launch_at(0, REG_CONST_ONE_PAGE);
+    struct wm_ctx *w = self();
+    if (w->num_asm_insts > 0)
+        launch_at(w, 0);
+}
+
+void wm_run(void) {
+    struct wm_ctx *w = self();
+    if (wm_generate() == 0)
+        launch_at(w, 0);
 }
 
 void wm_resume(int entry_asm_inst) {
-    /* Each asm instruction expands to 3 real instructions.
-     * We enter at the NOP0 of the target, which reads the source reg. */
-    launch_at(entry_asm_inst * 3, REG_CONST_ONE_PAGE);
+    struct wm_ctx *w = self();
+    /* Entered through the instruction's entry NOP, whose task switch to
+     * the movdbz pushes the error code that does the decrement */
+    if (entry_asm_inst < 0 || entry_asm_inst >= w->num_asm_insts)
+        return;
+    launch_at(w, entry_asm_inst);
+}
+
+void wm_set_host_idt(uint32_t base_addr, uint16_t table_limit) {
+    struct wm_ctx *w = self();
+    w->host_idt_base = base_addr;
+    w->host_idt_limit = table_limit;
 }
+
+uint64_t wm_last_cycles(void) {
+    struct wm_ctx *w = self();
+    return w->last_cycles;
+}
+
+int wm_cpu(void) {
+    return self()->index;
+}
+
+#endif /* !WM_HOSTGEN */
@@ -14,14 +14,39 @@
 /* Maximum number of registers (including constants) */
 #define MAX_REGISTERS     64
 
-/* Maximum number of movdbz assembly instructions */
+/* Maximum number of movdbz assembly instructions. A program this long
+ * fits the boot CPU's region only with 48MB of RAM or more (see
+ * wm_setup()); the other CPUs' regions hold about 20 movdbz. */
 #define MAX_ASM_INSTS     256
 
+/* Maximum number of CPUs, each running its own weird machine instance */
+#define WM_MAX_CPUS       8
+
 /*
  * Set up the page fault weird machine infrastructure.
  * Must be called after paging is enabled and the kernel is running.
+ * Sets up the boot CPU as instance 0, whose program region gets the RAM
+ * below mem_end that the other instances' regions leave. Returns -1
+ * (nothing set up) if mem_end leaves no room for them all.
+ */
+int wm_setup(uint32_t mem_end);
+
+/*
+ * Set up another CPU (1 .. WM_MAX_CPUS - 1) as that instance, on the CPU
+ * itself, after wm_setup() has run on the boot CPU: enables paging and
+ * loads its own GDT, IDT and task state. Every other call then acts on
+ * the calling CPU's instance, so CPUs run programs independently.
  */
-void wm_setup(void);
+void wm_setup_cpu(int cpu);
+
+/* Instance number of the calling CPU */
+int wm_cpu(void);
+
+/*
+ * Discard the current program (registers, constants, instructions) so a
+ * new one can be built. The hardware state set up by wm_setup() is kept.
+ */
+void wm_reset(void);
 
 /*
  * Generate a movdbz instruction.
@@ -30,22 +55,36 @@ void wm_setup(void);
  *   dest_nz:   assembly instruction number to jump to if result != 0
  *   dest_z:    assembly instruction number to jump to if result == 0
  *              Use -1 for exit (return to normal x86 execution).
+ * Instructions numbered outside [0, MAX_ASM_INSTS), branch targets past
+ * MAX_ASM_INSTS, or unallocated registers are rejected (nothing generated).
  */
 void wm_gen_movdbz(int asm_inst, int dest_reg, int src_reg, int dest_nz, int dest_z);
 
 /*
- * Set the initial value of a register.
+ * Set the value of a register. Registers must be written for the first
+ * time before any constant is allocated; after that a write only stores
+ * the value dword, so the bridge can call it between every exit.
+ * Returns 0, or -1 (nothing written) for a register out of range or a
+ * new register once constants are allocated: its page would be theirs.
  */
-void wm_write_reg(int reg_nr, uint32_t value);
+int wm_write_reg(int reg_nr, uint32_t value);
 
 /*
  * Read the current value of a register.
  */
 uint32_t wm_read_reg(int reg_nr);
 
+/* Write or read registers first_reg .. first_reg + count - 1 at once;
+ * wm_write_regs() returns -1 at the first write wm_write_reg() refuses */
+int wm_write_regs(int first_reg, const uint32_t *values, int count);
+void wm_read_regs(int first_reg, uint32_t *values, int count);
+
 /*
  * Allocate and initialize a constant register.
- * Returns the register number.
+ * Constants are interned: asking for a value that already has a constant
+ * register (or 1, which maps to WM_REG_CONST_ONE) returns that register,
+ * so constants must only ever be used as movdbz sources.
+ * Returns the register number, or -1 once MAX_REGISTERS are in use.
  */
 int wm_alloc_const(uint32_t value);
 
@@ -56,10 +95,38 @@ int wm_alloc_const(uint32_t value);
 void wm_run(void);
 
 /*
- * Generate all instruction pages for the current program.
+ * Finalize the current program: special registers, program GDT, TSS slot
+ * assignment, every instruction's pages, and one precomputed entry page
+ * directory per movdbz instruction.
  * Called once after all wm_gen_movdbz() calls, before the run loop.
+ * Returns 0, or -1 if the pages do not fit in the instance's program
+ * region; the program is then discarded. Instance 0's region is sized
+ * from RAM by wm_setup(), up to room for MAX_ASM_INSTS movdbz with all
+ * their NOPs; the other CPUs' regions are WM_REGION_PAGES each.
  */
-void wm_generate(void);
+int wm_generate(void);
+
+/*
+ * Task switches one branch of a generated movdbz costs: 1, or 2 when
+ * slot assignment had to route it through a NOP. Exits cost 1. Entering
+ * with wm_launch()/wm_resume() costs WM_ENTRY_SWITCHES more.
+ */
+int wm_branch_switches(int asm_inst, int zero);
+
+/*
+ * Retarget both branches of a generated movdbz instruction (-1 = exit).
+ * Only its page table entries and IDT gates are rewritten, plus a NOP
+ * if the new target needs one. Call between cascades, never from one.
+ * In a program loaded with fuel, a backward target (at or before
+ * asm_inst) is routed through the fuel check the loader added for it;
+ * the checks themselves cannot be patched or targeted.
+ * Returns 0, or -1 for an invalid instruction or target, a backward
+ * target no loop of the loaded program had, or when no room is left
+ * for a NOP.
+ */
+int wm_patch_branch(int asm_inst, int dest_nz, int dest_z);
+
+#define WM_ENTRY_SWITCHES 2
 
 /*
  * Run one step: launch (or resume) the weird machine.
@@ -72,15 +139,104 @@ void wm_launch(void);
 
 /*
  * Resume the weird machine from a given assembly instruction.
- * Used by the I/O bridge after servicing a request.
+ * Used by the I/O bridge after servicing a request. Only the TSS busy
+ * bits are reset; every page is reused from wm_generate().
  * entry_asm_inst: the movdbz instruction number to resume at.
  */
 void wm_resume(int entry_asm_inst);
 
+/*
+ * Register the normal-mode IDT. When set, wm_launch()/wm_resume() load
+ * the weird machine's IDT only for the duration of the cascade (with
+ * interrupts disabled) and restore this one, and the caller's interrupt
+ * flag, on exit.
+ */
+void wm_set_host_idt(uint32_t base_addr, uint16_t table_limit);
+
+/*
+ * Identity-map the physical range [base, base + size) with 4MB pages in
+ * the normal-mode page directory (which only maps low memory, the kernel
+ * and the program regions), e.g. for a PCI BAR. The weird machine's page directories never map it.
+ */
+void wm_map_mmio(uint32_t base, uint32_t size);
+
+/*
+ * Cascade profiling: TSC cycles spent in the most recent wm_launch() or
+ * wm_resume(), from entry until the exit task switch returns.
+ */
+uint64_t wm_last_cycles(void);
+
 /* Special register: writes are discarded */
 #define WM_REG_DISCARD    (-2)
 /* Special constant: always 1 */
 #define WM_REG_CONST_ONE  (-3)
+/* Program table operand: the program's i-th constant (see wm_load_program) */
+#define WM_REG_CONST(i)   (-16 - (i))
+
+/* One movdbz instruction in a program table; targets of -1 exit */
+struct wm_inst {
+    int16_t dest, src, nz, z;
+};
+
+/*
+ * A whole movdbz program, as emitted by the host compiler (tools/wmc.py).
+ * Registers r0 .. num_regs-1 start at 0; consts[] holds stored constant
+ * values (already value + 1), referenced as WM_REG_CONST(i).
+ *
+ * With a nonzero fuel budget every backward branch also decrements a
+ * fuel register, refilled to `fuel` on each launch or resume; when it
+ * runs out the program sets cmd_reg to WM_IO_OUT_OF_FUEL and exits, and
+ * wm_fuel_target() tells where to resume.
+ */
+struct wm_program {
+    int num_regs;
+    int num_consts;
+    const uint32_t *consts;
+    int num_insts;
+    const struct wm_inst *insts;
+    int cmd_reg;                /* Command register, for fuel exits */
+    uint32_t fuel;              /* Backward branches per resume, 0 = off */
+};
+
+/*
+ * Replace the current program with `prog`: wm_reset(), registers,
+ * constants, every instruction, then wm_generate().
+ * Returns 0, or -1 if the program does not fit (nothing usable is left).
+ * Fuel takes two registers past num_regs, a constant per loop target,
+ * and two instructions past num_insts per loop target plus one.
+ */
+int wm_load_program(const struct wm_program *prog);
+
+/* After a WM_IO_OUT_OF_FUEL exit: the instruction to wm_resume() at,
+ * or -1 if the program has no fuel */
+int wm_fuel_target(void);
+
+/*
+ * A prebuilt program image (see tools/wmimage.c): the program region
+ * exactly as wm_load_program() leaves it, stored as runs of non-zero
+ * dwords, plus the engine state that goes with it.
+ */
+#define WM_IMAGE_VERSION  3
+
+struct wm_image {
+    uint32_t version;           /* WM_IMAGE_VERSION */
+    uint32_t pages;             /* Program region pages covered */
+    uint32_t checksum;          /* wm_image_checksum() of those pages */
+    uint32_t state_words;
+    const uint32_t *state;      /* Register/instruction counts, interning */
+    const uint32_t *runs;       /* { offset, count, dwords... }, count 0 ends */
+};
+
+/*
+ * Install a prebuilt image in place of wm_load_program(): clear the used
+ * pages, copy the runs, restore the engine state. Returns -1 if the
+ * image does not match this engine or the caller is not instance 0
+ * (the caller then generates instead).
+ */
+int wm_load_image(const struct wm_image *img);
+
+/* Checksum of the current program's pages, comparable to wm_image.checksum */
+uint32_t wm_image_checksum(void);
 
 /* I/O bridge command codes (written to r_cmd by the movdbz program) */
 #define WM_IO_EXIT           0   /* Program done */
@@ -88,5 +244,7 @@ void wm_resume(int entry_asm_inst);
 #define WM_IO_WRITE_BYTE     2   /* Write r_data byte to serial */
 #define WM_IO_SEND_QUERY     3   /* Send accumulated buffer as query */
 #define WM_IO_RECV_RESPONSE  4   /* Receive response, relay bytes via serial */
+#define WM_IO_READ_LINE      5   /* Read and edit a whole line (cooked mode) */
+#define WM_IO_OUT_OF_FUEL    6   /* Fuel ran out (see struct wm_program) */
 
 #endif /* WEIRDMACHINE_H */
@@ -8,26 +8,106 @@ the proxy terminal. All serial traffic is logged to the screen.
 
 Wire protocol:
   Kernel -> Proxy: "READY\n"            (kernel booted)
+  Kernel -> Proxy: "CAPS:frame,ack,pipe\n"  (kernel accepts framed answers)
   Kernel -> Proxy: <echo chars + "\n">  (echo of keyboard input)
   Kernel -> Proxy: "Q:<prompt text>\n"  (query for Claude)
-  Proxy -> Kernel: "A:<response text>\\x04"  (answer, EOT terminated)
+  Proxy -> Kernel: "A:<response text>\\x04"  (answer, EOT terminated;
+                                             text streamed as generated)
+  Kernel -> Proxy: "ACK:<len>,<crc>\n"  (answer received, instead of echo)
+  Kernel -> Proxy: "NEXT:<tag>\n"      (ready for a pipelined answer)
+  Kernel -> Proxy: "STATS:<profile>\n"  (cascade profile, user typed stats)
   Kernel -> Proxy: "BYE\n"             (user typed quit)
 
+Framing: after CAPS:frame the proxy answers with frames instead of
+A:...\\x04. A frame is SOH (0x01), type, 16-bit LE length, CRC-16/CCITT
+(LE, init 0xFFFF) over type+length+payload, then the payload. Answers are
+'a' chunk frames ending with an 'A' frame; once the kernel has seen one,
+it sends its queries as 'Q' frames too. Payloads may contain any byte.
+When the kernel lists "ack", each answer starts with an empty 'k' frame:
+the kernel then skips its "Claude: ..." echo and replies with the answer's
+length and CRC, and the proxy logs its own copy, so the answer crosses
+the 115200-baud link once instead of twice.
+
+With "pipe", each framed answer starts with a 'P' frame holding the tag
+of the query it answers (0 for a 'Q' frame). Seeing it, the kernel sends
+lines typed while an answer streams as 'P' frames, a tag byte and the
+query, without waiting for its turn. The proxy asks each one as soon as
+the answer ahead of it is recorded, so it has the whole conversation as
+context, buffers what comes back and sends it when the kernel asks for
+its tag with NEXT:<tag>. Answers go out in order. --pipeline-early asks
+them the moment they arrive instead: faster, but without the exchanges
+still being answered ahead of them.
+
+Each query is routed: short, simple prompts go to a faster model with one
+console screen of max_tokens, the rest to the larger model with a few,
+and a request that has not started streaming by a deadline is retried
+on the other model (see Router).
+
+Each session keeps its conversation history (reset on READY/BYE) within
+a token budget; the system prompt and the history prefix are marked for
+API prompt caching.
+
+The transport is asyncio-based: serial input is read through a buffered
+stream and handled by one task while another streams the API response
+back, so echo traffic and status lines keep being logged while a request
+is in flight.
+
+The kernel echoes each keystroke long before the Q: line. After an idle
+spell, the first byte of a new line starts a warm-up: a cheap request
+that opens (or refreshes) the pooled TLS connection, and with
+--warm-cache a 1-token request that writes the conversation prefix to
+the prompt cache of each model the next query may be routed to. The
+query waits briefly for it, then goes out warm.
+
 Usage:
   # With QEMU serial on TCP:
   python3 proxy/claude_proxy.py --port 4321
 
+  # Daemon: many guests, shared client, 8 workers, 5 requests/s
+  python3 proxy/claude_proxy.py --ports 4321-4360 --workers 8 --rate 5
+  python3 proxy/claude_proxy.py --listen 4321   # guests: -serial tcp:HOST:4321
+
   # With QEMU serial on stdio (pipe mode):
   python3 proxy/claude_proxy.py --pipe
+
+  # Over an ivshmem shared-memory ring (see make run-shm):
+  python3 proxy/claude_proxy.py --shm /dev/shm/pagefault_claude
 """
 
 import argparse
-import socket
+import asyncio
+import binascii
+import hashlib
+import json
+import mmap
+import os
+import sqlite3
+import struct
 import sys
 import time
 
 EOT = b"\x04"
 
+# Framed protocol: SOH, type, length (16-bit LE), CRC-16/CCITT (LE) over
+# type + length + payload, payload. Negotiated by "CAPS:frame" after READY.
+FRAME_SOH = 0x01
+FRAME_QUERY = b"Q"
+FRAME_CHUNK = b"a"
+FRAME_ANSWER = b"A"
+FRAME_ACKREQ = b"k"
+FRAME_PIPE = b"P"
+FRAME_MAX = 1024
+
+# Shared-memory transport (ivshmem): header, then two byte rings
+SHM_MAGIC = 0x53434650             # "PFCS"
+SHM_VERSION = 1
+SHM_TX_HEAD, SHM_TX_TAIL = 0x40, 0x80    # Kernel -> host ring indices
+SHM_RX_HEAD, SHM_RX_TAIL = 0xC0, 0x100   # Host -> kernel ring indices
+SHM_DATA_OFF = 0x1000
+DEFAULT_SHM = "/dev/shm/pagefault_claude"
+
+DEFAULT_CACHE = "~/.cache/pagefault_claude/responses.db"
+
 BANNER = """
 ╔═══════════════════════════════════════════════════════╗
 ║  PageFault Claude - Weird Machine Proxy               ║
@@ -42,7 +122,7 @@ def create_anthropic_client():
     """Create Anthropic client. API key from environment."""
     try:
         import anthropic
-        return anthropic.Anthropic()
+        return anthropic.AsyncAnthropic()
     except ImportError:
         print("ERROR: 'anthropic' package not installed. Run: pip install anthropic",
               file=sys.stderr)
@@ -53,130 +133,1010 @@ def create_anthropic_client():
         sys.exit(1)
 
 
-def query_claude(client, prompt):
-    """Send a prompt to Claude and return the response text."""
+MODEL = "claude-sonnet-4-5-20250929"
+FAST_MODEL = "claude-haiku-4-5-20251001"
+
+SYSTEM_PROMPT = ("You are responding via a bizarre x86 page fault weird machine. "
+                 "Keep responses concise (1-3 paragraphs). Be helpful and fun.")
+
+
+# API idle time after which the pooled connection may have been closed
+WARM_IDLE = 30.0
+# Longest a query waits for a warm-up still in flight
+WARM_WAIT = 2.0
+# Longest to wait for the kernel's ACK line after an answer
+ACK_WAIT = 5.0
+# Longest to wait for the first chunk before asking the other model
+DEADLINE = 4.0
+
+# The kernel's console: VGA_WIDTH x VGA_HEIGHT, VGA_LINES rows of scrollback
+CONSOLE_COLS = 80
+CONSOLE_ROWS = 25
+CONSOLE_LINES = 256
+# Prompts up to this many tokens, with none of HARD_WORDS, go to FAST_MODEL
+SHORT_PROMPT = 16
+HARD_WORDS = {"explain", "why", "how", "compare", "prove", "derive", "design",
+              "code", "implement", "debug", "write", "analyze", "step"}
+
+
+def estimate_tokens(text):
+    """Rough token count (about 4 characters per token)."""
+    return len(text) // 4 + 1
+
+
+class Conversation:
+    """Per-session message history with a token budget.
+
+    When the history plus the new query exceeds the budget, the
+    "oldest" policy drops the oldest exchanges until it fits and the
+    "reset" policy starts over with no history.
+    """
+
+    def __init__(self, budget=4000, policy="oldest"):
+        self.budget = budget
+        self.policy = policy
+        self.turns = []     # [(query, answer), ...]
+
+    def reset(self):
+        self.turns = []
+
+    def tokens(self):
+        return sum(estimate_tokens(q) + estimate_tokens(a) for q, a in self.turns)
+
+    def trim(self, query):
+        need = estimate_tokens(query)
+        if self.policy == "reset":
+            if self.tokens() + need > self.budget:
+                self.turns = []
+            return
+        while self.turns and self.tokens() + need > self.budget:
+            self.turns.pop(0)
+
+    def messages(self, query):
+        """API messages for the next query.
+
+        The end of the existing history is marked as a prompt-cache
+        breakpoint: it is the stable prefix shared with the next request.
+        """
+        self.trim(query)
+        messages = []
+        for q, a in self.turns:
+            messages.append({"role": "user", "content": q})
+            messages.append({"role": "assistant", "content": a})
+        if messages:
+            messages[-1] = {
+                "role": "assistant",
+                "content": [{"type": "text", "text": messages[-1]["content"],
+                             "cache_control": {"type": "ephemeral"}}],
+            }
+        messages.append({"role": "user", "content": query})
+        return messages
+
+    def record(self, query, answer):
+        self.turns.append((query, answer))
+
+
+# The system prompt never changes, so it is always cached
+SYSTEM_BLOCKS = [{"type": "text", "text": SYSTEM_PROMPT,
+                  "cache_control": {"type": "ephemeral"}}]
+
+
+def answer_budget(rows):
+    """max_tokens for an answer that fills `rows` console rows."""
+    return rows * CONSOLE_COLS // 4     # estimate_tokens() ratio
+
+
+class Router:
+    """Picks the model and output budget for each query.
+
+    "auto" sends short prompts without any of HARD_WORDS to FAST_MODEL
+    with one screen of answer, and everything else to MODEL with
+    `screens` screens (at most the scrollback). "fast" and "large" always
+    pick one model. With a deadline, a request that has not produced its
+    first chunk in time is abandoned for the other model with the same
+    budget; the answer has not started on the wire yet, so nothing is lost.
+    """
+
+    def __init__(self, policy="auto", screens=2, deadline=DEADLINE):
+        self.policy = policy
+        rows = CONSOLE_ROWS - 2         # The prompt line and the blank line after
+        self.small = answer_budget(rows)
+        self.large = answer_budget(min(CONSOLE_LINES, rows * screens))
+        self.deadline = deadline or None
+
+    def route(self, query):
+        """([(model, max_tokens), ...] to try in order, reason to log)."""
+        if self.policy == "auto":
+            words = {w.strip("?.,:;!'\"()") for w in query.lower().split()}
+            hard = words & HARD_WORDS
+            fast = estimate_tokens(query) <= SHORT_PROMPT and not hard
+            reason = ("short prompt" if fast else
+                      f"hard prompt ({', '.join(sorted(hard))})" if hard else "long prompt")
+        else:
+            fast = self.policy == "fast"
+            reason = f"--route {self.policy}"
+        if fast:
+            order = [(FAST_MODEL, self.small), (MODEL, self.small)]
+        else:
+            order = [(MODEL, self.large), (FAST_MODEL, self.large)]
+        return (order if self.deadline else order[:1]), reason
+
+    def models(self):
+        """Models a query may be sent to first (the prompt cache is per model)."""
+        if self.policy == "auto":
+            return [FAST_MODEL, MODEL]
+        return [FAST_MODEL if self.policy == "fast" else MODEL]
+
+
+async def query_claude(client, messages, route=((MODEL, 512),), deadline=None, log=None,
+                       answered=None):
+    """Send a conversation to Claude and yield the response text as it streams in.
+
+    `route` lists (model, max_tokens) to try in order: every model but
+    the last gets `deadline` seconds to start streaming. An answer cut
+    off at max_tokens ends with " [...]". The model that answers is
+    appended to the `answered` list, if given.
+    """
+    for i, (model, max_tokens) in enumerate(route):
+        last = i == len(route) - 1
+        try:
+            async with client.messages.stream(
+                model=model,
+                max_tokens=max_tokens,
+                system=SYSTEM_BLOCKS,
+                messages=messages,
+            ) as stream:
+                texts = stream.text_stream.__aiter__()
+                try:
+                    first = await asyncio.wait_for(texts.__anext__(),
+                                                   None if last else deadline)
+                except asyncio.TimeoutError:
+                    if log is not None:
+                        log(f"[route] {model} silent for {deadline:g}s, "
+                            f"trying {route[i + 1][0]}")
+                    continue
+                except StopAsyncIteration:
+                    return
+                if answered is not None:
+                    answered.append(model)
+                yield first
+                async for text in texts:
+                    yield text
+                if (await stream.get_final_message()).stop_reason == "max_tokens":
+                    yield " [...]"
+            return
+        except Exception as e:
+            raise APIError(e)
+
+
+class APIError(Exception):
+    """Raised through a response stream when the API call fails."""
+
+
+async def warm_up(client, conversation=None, models=(MODEL,)):
+    """Open or refresh the client's connection to the API ahead of a query.
+
+    With a conversation, also send its history to each of `models` with a
+    1-token reply so the prefix marked in Conversation.messages() is in
+    their prompt caches (prefixes below a model's minimum cacheable length
+    are not cached).
+    """
+    fast = client.with_options(max_retries=0, timeout=10.0)
+    if conversation is not None and conversation.turns:
+        messages = conversation.messages(".")
+        await asyncio.gather(*(fast.messages.create(model=model, max_tokens=1,
+                                                    system=SYSTEM_BLOCKS, messages=messages)
+                               for model in models))
+    else:
+        await fast.models.list(limit=1)
+
+
+class ResponseCache:
+    """On-disk LRU cache of complete answers (SQLite).
+
+    Keyed by (model, system prompt, conversation prefix, query). Entries
+    older than `ttl` seconds are ignored and purged; beyond `max_entries`
+    the least recently used ones are evicted.
+    """
+
+    def __init__(self, path, ttl=7 * 24 * 3600, max_entries=1000):
+        path = os.path.expanduser(path)
+        os.makedirs(os.path.dirname(path) or ".", exist_ok=True)
+        self.db = sqlite3.connect(path)
+        self.db.execute("CREATE TABLE IF NOT EXISTS responses ("
+                        "key TEXT PRIMARY KEY, answer TEXT, "
+                        "created REAL, used REAL)")
+        self.db.commit()
+        self.ttl = ttl
+        self.max_entries = max_entries
+        self.hits = 0
+        self.misses = 0
+
+    @staticmethod
+    def key(model, system, turns, query):
+        blob = json.dumps([model, system, turns, query], ensure_ascii=False)
+        return hashlib.sha256(blob.encode("utf-8")).hexdigest()
+
+    def get(self, *keys):
+        """The answer under the first of `keys` that has one, or None."""
+        now = time.time()
+        for key in keys:
+            row = self.db.execute("SELECT answer FROM responses "
+                                  "WHERE key = ? AND created > ?",
+                                  (key, now - self.ttl)).fetchone()
+            if row is not None:
+                break
+        else:
+            self.misses += 1
+            return None
+        self.hits += 1
+        self.db.execute("UPDATE responses SET used = ? WHERE key = ?", (now, key))
+        self.db.commit()
+        return row[0]
+
+    def put(self, key, answer):
+        now = time.time()
+        self.db.execute("INSERT OR REPLACE INTO responses VALUES (?, ?, ?, ?)",
+                        (key, answer, now, now))
+        self.db.execute("DELETE FROM responses WHERE created <= ?", (now - self.ttl,))
+        self.db.execute("DELETE FROM responses WHERE key NOT IN ("
+                        "SELECT key FROM responses ORDER BY used DESC LIMIT ?)",
+                        (self.max_entries,))
+        self.db.commit()
+
+    def close(self):
+        self.db.close()
+
+
+async def cached_response(answer):
+    yield answer
+
+
+def prefetch(chunks):
+    """Start pulling a response now; return a stream that replays it later."""
+    buf = asyncio.Queue()
+
+    async def pump():
+        try:
+            async for text in chunks:
+                buf.put_nowait(text)
+        except APIError as e:
+            buf.put_nowait(e)
+        buf.put_nowait(None)
+
+    task = asyncio.get_running_loop().create_task(pump())
+
+    async def replay():
+        try:
+            while (item := await buf.get()) is not None:
+                if isinstance(item, APIError):
+                    raise item
+                yield item
+        finally:
+            task.cancel()
+
+    return replay()
+
+
+async def mock_response(query):
+    """Mock mode: stream the echo back word by word."""
+    for word in f"[Mock] You said: {query}".split(" "):
+        yield word + " "
+
+
+def encode_frame(ftype, payload):
+    """Build one frame; payload must be at most FRAME_MAX bytes."""
+    head = ftype + len(payload).to_bytes(2, "little")
+    crc = binascii.crc_hqx(head + payload, 0xFFFF)
+    return bytes([FRAME_SOH]) + head + crc.to_bytes(2, "little") + payload
+
+
+async def send_response(serial, chunks, framed=False, ack=False, tag=None):
+    """Relay response chunks to the kernel as they arrive.
+
+    Text mode sends one EOT-terminated A: message; EOT bytes inside the
+    text would end it early, so they are dropped. Framed mode sends each
+    chunk as FRAME_CHUNK frames and ends with an empty FRAME_ANSWER, so
+    any byte is allowed; with ack, a FRAME_ACKREQ goes out with the first
+    of them, and with a tag, a FRAME_PIPE naming the query answered. An
+    API failure is reported inline as "[API Error: ...]".
+    Returns (text sent, seconds to first chunk, completed without error).
+    """
+    start = time.monotonic()
+    first = None
+    parts = []
+    ok = True
+    # Sent with the first frame so the kernel is not left waiting on it
+    lead = encode_frame(FRAME_ACKREQ, b"") if framed and ack else b""
+    if framed and tag is not None:
+        lead += encode_frame(FRAME_PIPE, bytes([tag]))
+
+    async def emit(text):
+        nonlocal lead
+        data = text.encode("utf-8")
+        if not framed:
+            await serial.write(data)
+            return
+        for i in range(0, len(data), FRAME_MAX):
+            await serial.write(lead + encode_frame(FRAME_CHUNK, data[i:i + FRAME_MAX]))
+            lead = b""
+
+    if not framed:
+        await serial.write(b"A:")
     try:
-        response = client.messages.create(
-            model="claude-sonnet-4-5-20250929",
-            max_tokens=512,
-            system="You are responding via a bizarre x86 page fault weird machine. "
-                   "Keep responses concise (1-3 paragraphs). Be helpful and fun.",
-            messages=[{"role": "user", "content": prompt}],
-        )
-        return response.content[0].text
-    except Exception as e:
-        return f"[API Error: {e}]"
+        async for text in chunks:
+            if not framed:
+                text = text.replace("\x04", "")
+            if not text:
+                continue
+            if first is None:
+                first = time.monotonic() - start
+            await emit(text)
+            parts.append(text)
+    except APIError as e:
+        ok = False
+        error = f"[API Error: {e}]"
+        await emit(error)
+        parts.append(error)
+    await serial.write(lead + encode_frame(FRAME_ANSWER, b"") if framed else EOT)
+    return "".join(parts), first, ok
 
 
 class SerialConnection:
-    """Abstraction over TCP socket or stdin/stdout for serial communication."""
+    """Buffered asyncio stream over a TCP socket or stdin/stdout."""
 
-    def __init__(self, mode, host="127.0.0.1", port=4321):
-        self.mode = mode
+    def __init__(self, reader, writer):
+        self.reader = reader
+        self.writer = writer
+        self.on_line_start = None   # Called with the first byte of each text line
+
+    @classmethod
+    async def open(cls, mode, host="127.0.0.1", port=4321, attempts=30):
         if mode == "tcp":
-            self.sock = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
             print(f"Connecting to QEMU serial at {host}:{port}...", file=sys.stderr)
-            for attempt in range(30):
+            for attempt in range(attempts):
                 try:
-                    self.sock.connect((host, port))
+                    reader, writer = await asyncio.open_connection(host, port)
                     print("Connected.", file=sys.stderr)
-                    return
-                except ConnectionRefusedError:
-                    if attempt < 29:
-                        time.sleep(1)
-            print("ERROR: Could not connect to QEMU serial port.", file=sys.stderr)
-            sys.exit(1)
+                    return cls(reader, writer)
+                except (ConnectionRefusedError, OSError):
+                    if attempt < attempts - 1:
+                        await asyncio.sleep(1)
+            raise ConnectionError("Could not connect to QEMU serial port")
+
         # pipe mode uses stdin/stdout
+        loop = asyncio.get_running_loop()
+        reader = asyncio.StreamReader()
+        await loop.connect_read_pipe(
+            lambda: asyncio.StreamReaderProtocol(reader), sys.stdin)
+        transport, protocol = await loop.connect_write_pipe(
+            asyncio.streams.FlowControlMixin, sys.stdout)
+        writer = asyncio.StreamWriter(transport, protocol, reader, loop)
+        return cls(reader, writer)
 
-    def readline(self):
+    async def readline(self):
         """Read a line (terminated by \\n) from serial."""
-        if self.mode == "tcp":
-            buf = b""
-            while True:
-                c = self.sock.recv(1)
-                if not c:
-                    raise ConnectionError("Serial connection closed")
-                if c == b"\n":
-                    return buf.decode("utf-8", errors="replace")
-                buf += c
-        else:
-            return sys.stdin.readline().rstrip("\n")
+        line = await self.reader.readline()
+        if not line:
+            raise ConnectionError("Serial connection closed")
+        return line.rstrip(b"\n").decode("utf-8", errors="replace")
+
+    async def read_message(self):
+        """Read a text line or a frame from serial.
+
+        Returns (None, line) for text, (type, payload) for a frame, and
+        (None, None) for a frame that fails its length or CRC check;
+        the caller resyncs on the next SOH or line.
+        """
+        first = await self.reader.readexactly(1)
+        if first[0] != FRAME_SOH:
+            if self.on_line_start is not None and first != b"\n":
+                self.on_line_start(first)
+            rest = b"" if first == b"\n" else await self.reader.readline()
+            line = (first + rest).rstrip(b"\n")
+            return None, line.decode("utf-8", errors="replace")
 
-    def write(self, data):
+        head = await self.reader.readexactly(5)
+        length = int.from_bytes(head[1:3], "little")
+        if length > FRAME_MAX:
+            return None, None
+        payload = await self.reader.readexactly(length)
+        crc = int.from_bytes(head[3:5], "little")
+        if binascii.crc_hqx(head[:3] + payload, 0xFFFF) != crc:
+            return None, None
+        return head[:1], payload
+
+    async def write(self, data):
         """Write bytes to serial."""
         if isinstance(data, str):
             data = data.encode("utf-8")
-        if self.mode == "tcp":
-            self.sock.sendall(data)
-        else:
-            sys.stdout.buffer.write(data)
-            sys.stdout.buffer.flush()
+        self.writer.write(data)
+        await self.writer.drain()
 
-    def close(self):
-        if self.mode == "tcp":
-            self.sock.close()
+    async def close(self):
+        self.writer.close()
+        try:
+            await self.writer.wait_closed()
+        except Exception:
+            pass
 
 
-def main():
-    parser = argparse.ArgumentParser(description="PageFault Claude host proxy")
-    parser.add_argument("--port", type=int, default=4321,
-                        help="TCP port for QEMU serial (default: 4321)")
-    parser.add_argument("--host", default="127.0.0.1",
-                        help="Host for QEMU serial (default: 127.0.0.1)")
-    parser.add_argument("--pipe", action="store_true",
-                        help="Use stdin/stdout instead of TCP")
-    parser.add_argument("--no-api", action="store_true",
-                        help="Mock mode: echo queries instead of calling Claude")
-    args = parser.parse_args()
+class ShmConnection(SerialConnection):
+    """The kernel's shared-memory rings, mapped from the ivshmem backing file.
 
-    if args.no_api:
-        client = None
-    else:
-        client = create_anthropic_client()
+    A pump task polls the kernel->host ring and feeds a StreamReader, so
+    Session reads it exactly like a serial stream. Writes go straight
+    into the host->kernel ring. Only the proxy's own indices (tx tail,
+    rx head) are ever written here.
+    """
 
-    mode = "pipe" if args.pipe else "tcp"
-    serial = SerialConnection(mode, args.host, args.port)
+    POLL_IDLE = 0.001
 
-    print(BANNER, file=sys.stderr)
-    print("Waiting for kernel boot...", file=sys.stderr)
+    def __init__(self, mem):
+        super().__init__(asyncio.StreamReader(), None)
+        self.mem = mem
+        self.size = self.u32(8)
+        self.tx_data = SHM_DATA_OFF
+        self.rx_data = SHM_DATA_OFF + self.size
+        self.pump = asyncio.get_running_loop().create_task(self.pump_loop())
 
-    try:
-        # Wait for kernel READY signal
+    @classmethod
+    async def open(cls, path, attempts=30):
+        print(f"Waiting for the kernel's shared-memory ring in {path}...",
+              file=sys.stderr)
+        for attempt in range(attempts):
+            try:
+                with open(path, "r+b") as f:
+                    mem = mmap.mmap(f.fileno(), 0)
+                if struct.unpack_from("<II", mem, 0) == (SHM_MAGIC, SHM_VERSION):
+                    print("Connected.", file=sys.stderr)
+                    return cls(mem)
+                mem.close()
+            except (OSError, ValueError):
+                pass
+            if attempt < attempts - 1:
+                await asyncio.sleep(1)
+        raise ConnectionError("Kernel shared-memory ring not found")
+
+    def u32(self, off):
+        return struct.unpack_from("<I", self.mem, off)[0]
+
+    def set_u32(self, off, value):
+        struct.pack_into("<I", self.mem, off, value & 0xFFFFFFFF)
+
+    async def pump_loop(self):
+        mask = self.size - 1
+        while True:
+            tail = self.u32(SHM_TX_TAIL)
+            avail = (self.u32(SHM_TX_HEAD) - tail) & 0xFFFFFFFF
+            if not avail:
+                await asyncio.sleep(self.POLL_IDLE)
+                continue
+            off = tail & mask
+            run = min(avail, self.size - off)
+            start = self.tx_data + off
+            self.reader.feed_data(self.mem[start:start + run])
+            self.set_u32(SHM_TX_TAIL, tail + run)
+            await asyncio.sleep(0)
+
+    async def write(self, data):
+        """Copy bytes into the host->kernel ring, waiting while it is full."""
+        if isinstance(data, str):
+            data = data.encode("utf-8")
+        mask = self.size - 1
+        while data:
+            head = self.u32(SHM_RX_HEAD)
+            space = self.size - ((head - self.u32(SHM_RX_TAIL)) & 0xFFFFFFFF)
+            if not space:
+                await asyncio.sleep(self.POLL_IDLE)
+                continue
+            off = head & mask
+            run = min(len(data), space, self.size - off)
+            start = self.rx_data + off
+            self.mem[start:start + run] = data[:run]
+            self.set_u32(SHM_RX_HEAD, head + run)   # Publish after the data
+            data = data[run:]
+
+    async def close(self):
+        self.pump.cancel()
+        try:
+            await self.pump
+        except asyncio.CancelledError:
+            pass
+        self.mem.close()
+
+
+class RateLimiter:
+    """Token bucket: at most `rate` acquisitions per second, bursts of `burst`."""
+
+    def __init__(self, rate, burst=1):
+        self.rate = rate
+        self.burst = burst
+        self.tokens = burst
+        self.stamp = time.monotonic()
+        self.lock = asyncio.Lock()
+
+    async def acquire(self):
+        async with self.lock:
+            while True:
+                now = time.monotonic()
+                self.tokens = min(self.burst,
+                                  self.tokens + (now - self.stamp) * self.rate)
+                self.stamp = now
+                if self.tokens >= 1:
+                    self.tokens -= 1
+                    return
+                await asyncio.sleep((1 - self.tokens) / self.rate)
+
+
+class Limits:
+    """Shared limits on API requests across all sessions of a daemon.
+
+    A bounded pool of `workers` concurrent requests plus an optional
+    global rate limit. Waiters are served in FIFO order and each session
+    has at most one request in flight, so sessions get turns round-robin.
+    """
+
+    def __init__(self, workers=4, rate=None):
+        self.pool = asyncio.Semaphore(workers)
+        self.rate = RateLimiter(rate, burst=workers) if rate else None
+
+    async def __aenter__(self):
+        await self.pool.acquire()
+        if self.rate is not None:
+            await self.rate.acquire()
+
+    async def __aexit__(self, *exc):
+        self.pool.release()
+
+
+async def limited(limits, chunks):
+    """Hold a worker slot for the whole of a streamed response."""
+    async with limits:
+        async for text in chunks:
+            yield text
+
+
+class Session:
+    """One guest: reads serial lines and answers queries concurrently."""
+
+    def __init__(self, serial, client, conversation=None, cache=None,
+                 limits=None, name=None, framing=True, warm=True, warm_cache=False,
+                 ack=True, pipeline=True, pipeline_early=False, router=None):
+        self.serial = serial
+        self.client = client
+        self.conversation = conversation or Conversation()
+        self.cache = cache
+        self.limits = limits
+        self.tag = f"[{name}] " if name else ""
+        self.queries = asyncio.Queue()
+        self.framed = False         # Negotiated via "CAPS:frame"
+        self.allow_framing = framing
+        self.ack = False            # Negotiated via "CAPS:...,ack"
+        self.allow_ack = ack
+        self.ack_wait = None        # Future for the kernel's ACK line
+        self.pipe = False           # Negotiated via "CAPS:...,pipe"
+        self.allow_pipe = pipeline
+        self.pipe_early = pipeline_early    # Ask pipelined queries on arrival
+        self.router = router or Router()
+        self.next_tags = asyncio.Queue()    # Tags from the kernel's NEXT: lines
+        self.warm_cache = warm_cache
+        self.warming = None         # Warm-up task
+        self.last_api = 0.0         # time.monotonic() of the last API traffic
+        self.busy = False           # Answering a query
+        if warm and client is not None:
+            serial.on_line_start = self.line_started
+
+    def line_started(self, first):
+        """Typing has begun: warm the connection if it may have gone cold."""
+        if first == b"Q" or self.busy or not self.queries.empty():
+            return      # The query itself, or one is already going out
+        if self.warming is not None and not self.warming.done():
+            return
+        now = time.monotonic()
+        if now - self.last_api < WARM_IDLE:
+            return
+        self.last_api = now
+        self.warming = asyncio.get_running_loop().create_task(self.warm())
+
+    async def warm(self):
+        t0 = time.monotonic()
+        try:
+            await warm_up(self.client, self.conversation if self.warm_cache else None,
+                          self.router.models())
+        except Exception as e:
+            self.log(f"[warm] failed: {e}")
+            return
+        self.log(f"[warm] connection ready in {(time.monotonic() - t0) * 1000:.0f}ms"
+                 + (", prefix cached" if self.warm_cache and self.conversation.turns
+                    else ""))
+
+    def log(self, msg):
+        print(f"{self.tag}{msg}", file=sys.stderr)
+
+    async def wait_ready(self):
+        """Wait for kernel READY signal."""
         while True:
-            line = serial.readline()
-            print(f"[serial] {line}", file=sys.stderr)
+            line = await self.serial.readline()
+            self.log(f"[serial] {line}")
             if line.strip() == "READY":
-                print("Kernel ready! Type in the QEMU window.\n", file=sys.stderr)
-                break
+                self.log("Kernel ready! Type in the QEMU window.\n")
+                return
 
-        # Main loop: listen for Q: queries and BYE
+    async def read_loop(self):
+        """Log every serial line; queue Q: queries; return on BYE."""
         while True:
-            line = serial.readline()
-            print(f"[serial] {line}", file=sys.stderr)
+            try:
+                ftype, line = await self.serial.read_message()
+            except asyncio.IncompleteReadError:
+                raise ConnectionError("Serial connection closed")
+
+            if line is None:
+                self.log("[frame] bad frame, dropped")
+                continue
+            if ftype is not None:
+                if ftype == FRAME_QUERY:
+                    query = line.decode("utf-8", errors="replace")
+                    self.log(f"[query] {query} (framed)")
+                    self.queries.put_nowait((query, 0 if self.pipe else None, None))
+                elif ftype == FRAME_PIPE and line:
+                    tag, query = line[0], line[1:].decode("utf-8", errors="replace")
+                    self.log(f"[query #{tag}] {query} (pipelined)")
+                    prepared = self.prepare(query, early=True) if self.pipe_early else None
+                    self.queries.put_nowait((query, tag, prepared))
+                else:
+                    self.log(f"[frame] unexpected type {ftype!r}")
+                continue
+
+            self.log(f"[serial] {line}")
 
-            if line.startswith("Q:"):
+            if line.startswith("CAPS:"):
+                caps = line[5:].strip().split(",")
+                if "frame" in caps and self.allow_framing:
+                    self.log("Kernel supports framing; switching to framed answers.")
+                    self.framed = True
+                    if "ack" in caps and self.allow_ack:
+                        self.log("Kernel supports acks; answers will not be echoed.")
+                        self.ack = True
+                    if "pipe" in caps and self.allow_pipe:
+                        self.log("Kernel supports pipelining; typed-ahead queries "
+                                 "will be answered in parallel.")
+                        self.pipe = True
+
+            elif line.startswith("ACK:"):
+                length, _, crc = line[4:].partition(",")
+                if self.ack_wait is not None and not self.ack_wait.done():
+                    try:
+                        self.ack_wait.set_result((int(length), int(crc)))
+                    except ValueError:
+                        self.ack_wait.set_result(None)
+
+            elif line.startswith("NEXT:"):
+                try:
+                    self.next_tags.put_nowait(int(line[5:]))
+                except ValueError:
+                    pass
+
+            elif line.startswith("Q:"):
                 query = line[2:]
-                print(f"[query] {query}", file=sys.stderr)
+                self.log(f"[query] {query}")
+                self.queries.put_nowait((query, None, None))
 
-                if client is not None:
-                    response = query_claude(client, query)
-                else:
-                    response = f"[Mock] You said: {query}"
+            elif line.startswith("STATS:"):
+                self.log(f"[stats] {line[6:].strip()}")
 
-                # Send response to kernel
-                serial.write(b"A:" + response.encode("utf-8") + EOT)
-                print(f"[response sent]", file=sys.stderr)
+            elif line.strip() == "READY":
+                self.log("Kernel rebooted; conversation reset.")
+                self.conversation.reset()
+                self.framed = False
+                self.ack = False
+                self.pipe = False
 
             elif line.strip() == "BYE":
-                print("Session ended. The weird machine has halted.", file=sys.stderr)
+                self.log("Session ended. The weird machine has halted.")
+                self.conversation.reset()
                 return
 
             # Otherwise it's echo/status output — already logged above
 
-    except (KeyboardInterrupt, ConnectionError) as e:
+    def prepare(self, query, early=False):
+        """Look the query up in the cache or start it on the API.
+
+        Returns (chunks, cached answer or None, cache key or None). The
+        key is a function: it is only known once a model has answered, and
+        the answer is cached under that model. With early, an API response
+        is fetched right away and buffered until the caller streams it.
+        """
+        messages = self.conversation.messages(query)
+
+        route, reason = self.router.route(query)
+        models = [model for model, _ in route] if self.client is not None else ["mock"]
+        answered = []
+        cached = key = None
+        if self.cache is not None:
+            turns = list(self.conversation.turns)
+
+            def key(model=None):
+                return ResponseCache.key(model or (answered or models)[0], SYSTEM_PROMPT,
+                                         turns, query)
+
+            # Whichever model answered it last time, in routing order
+            cached = self.cache.get(*(key(model) for model in models))
+            self.log(f"[cache] {'hit' if cached is not None else 'miss'} "
+                     f"(hits={self.cache.hits} misses={self.cache.misses})")
+
+        if cached is not None:
+            chunks = cached_response(cached)
+        elif self.client is not None:
+            self.log(f"[route] {route[0][0]}, max_tokens {route[0][1]} ({reason})")
+            chunks = query_claude(self.client, messages, route, self.router.deadline,
+                                  self.log, answered)
+            if self.limits is not None:
+                chunks = limited(self.limits, chunks)
+            if early:
+                chunks = prefetch(chunks)
+        else:
+            chunks = mock_response(query)
+        return chunks, cached, key
+
+    async def answer_loop(self):
+        """Answer queued queries in order, streaming each response."""
+        while True:
+            query, tag, prepared = await self.queries.get()
+            self.busy = True
+            if prepared is None:
+                # Now, after the answer ahead of it is recorded, so the
+                # query has it as context; pipelined ones are buffered
+                # while the kernel catches up to them
+                if self.warming is not None and not self.warming.done():
+                    await asyncio.wait([self.warming], timeout=WARM_WAIT)
+                prepared = self.prepare(query, early=bool(tag))
+            chunks, cached, key = prepared
+            if tag:
+                # Pipelined: hold the answer until the kernel is reading it
+                ready = await self.next_tags.get()
+                if ready != tag:
+                    self.log(f"[pipe] kernel is ready for #{ready}, next answer is #{tag}")
+
+            # Stream response to kernel as it is generated
+            ack = self.framed and self.ack
+            if ack:
+                self.ack_wait = asyncio.get_running_loop().create_future()
+            answer, ttft, ok = await send_response(self.serial, chunks, self.framed, ack, tag)
+            if ack:
+                await self.check_ack(answer)
+            self.busy = False
+            if cached is None:
+                self.last_api = time.monotonic()
+            if ok:
+                if key is not None and cached is None:
+                    self.cache.put(key(), answer)
+                self.conversation.record(query, answer)
+            ttft_ms = f"{ttft * 1000:.0f}ms" if ttft is not None else "n/a"
+            self.log(f"[response sent] {len(answer.encode())} bytes, "
+                     f"first chunk after {ttft_ms}, "
+                     f"history {len(self.conversation.turns)} turns "
+                     f"(~{self.conversation.tokens()} tokens)")
+
+    async def check_ack(self, answer):
+        """Log our copy of an answer the kernel acknowledged instead of echoing."""
+        self.log(f"Claude: {answer}")
+        try:
+            got = await asyncio.wait_for(self.ack_wait, ACK_WAIT)
+        except asyncio.TimeoutError:
+            got = "none"
+        finally:
+            self.ack_wait = None
+        data = answer.encode("utf-8")
+        want = (len(data), binascii.crc_hqx(data, 0xFFFF))
+        if got == want:
+            self.log(f"[ack] {want[0]} bytes, crc ok")
+        else:
+            self.log(f"[ack] mismatch: kernel {got}, sent {want}")
+
+    async def run(self):
+        await self.wait_ready()
+        answer = asyncio.create_task(self.answer_loop())
+        try:
+            await self.read_loop()
+        finally:
+            answer.cancel()
+            if self.warming is not None:
+                self.warming.cancel()
+
+
+def router_from(args):
+    return Router(args.route, args.screens, args.deadline)
+
+
+def parse_ports(spec):
+    """'4321-4324,4400' -> [4321, 4322, 4323, 4324, 4400]"""
+    ports = []
+    for part in spec.split(","):
+        lo, _, hi = part.partition("-")
+        ports.extend(range(int(lo), int(hi or lo) + 1))
+    return ports
+
+
+async def serve_port(args, port, client, cache, limits):
+    """Daemon: keep a session on one guest's serial port, reconnecting
+    whenever the guest goes away (e.g. after quit or a restart)."""
+    while True:
+        try:
+            serial = await SerialConnection.open("tcp", args.host, port)
+        except ConnectionError:
+            await asyncio.sleep(5)
+            continue
+        conversation = Conversation(args.history_tokens, args.truncate)
+        try:
+            await Session(serial, client, conversation, cache, limits, port,
+                          framing=not args.no_framing, warm=not args.no_warm,
+                          warm_cache=args.warm_cache, ack=not args.no_ack,
+                          pipeline=not args.no_pipeline,
+                          pipeline_early=args.pipeline_early, router=router_from(args)).run()
+        except ConnectionError as e:
+            print(f"[{port}] disconnected ({e})", file=sys.stderr)
+        finally:
+            await serial.close()
+        await asyncio.sleep(1)
+
+
+async def serve_listen(args, client, cache, limits):
+    """Daemon: accept guests connecting to us (QEMU -serial tcp:HOST:PORT)."""
+    async def handle(reader, writer):
+        peer = writer.get_extra_info("peername")
+        name = f"{peer[0]}:{peer[1]}" if peer else "guest"
+        serial = SerialConnection(reader, writer)
+        conversation = Conversation(args.history_tokens, args.truncate)
+        try:
+            await Session(serial, client, conversation, cache, limits, name,
+                          framing=not args.no_framing, warm=not args.no_warm,
+                          warm_cache=args.warm_cache, ack=not args.no_ack,
+                          pipeline=not args.no_pipeline,
+                          pipeline_early=args.pipeline_early, router=router_from(args)).run()
+        except ConnectionError as e:
+            print(f"[{name}] disconnected ({e})", file=sys.stderr)
+        finally:
+            await serial.close()
+
+    server = await asyncio.start_server(handle, args.host, args.listen)
+    print(f"Listening for guests on {args.host}:{args.listen}", file=sys.stderr)
+    async with server:
+        await server.serve_forever()
+
+
+async def run_daemon(args, client, cache):
+    """Serve many guests at once with one client and shared limits."""
+    limits = Limits(args.workers, args.rate)
+    print(BANNER, file=sys.stderr)
+    tasks = []
+    if args.ports:
+        ports = parse_ports(args.ports)
+        print(f"Serving {len(ports)} guest ports with {args.workers} workers",
+              file=sys.stderr)
+        tasks += [serve_port(args, p, client, cache, limits) for p in ports]
+    if args.listen:
+        tasks.append(serve_listen(args, client, cache, limits))
+    try:
+        await asyncio.gather(*tasks)
+    finally:
+        if cache is not None:
+            print(f"[cache] {cache.hits} hits, {cache.misses} misses", file=sys.stderr)
+            cache.close()
+
+
+async def run_proxy(args):
+    if args.no_api:
+        client = None
+    else:
+        client = create_anthropic_client()
+
+    cache = None
+    if args.cache:
+        cache = ResponseCache(args.cache, args.cache_ttl, args.cache_size)
+
+    if args.ports or args.listen:
+        await run_daemon(args, client, cache)
+        return
+
+    mode = "pipe" if args.pipe else "tcp"
+    try:
+        if args.shm:
+            serial = await ShmConnection.open(args.shm)
+        else:
+            serial = await SerialConnection.open(mode, args.host, args.port)
+    except ConnectionError as e:
+        print(f"ERROR: {e}.", file=sys.stderr)
+        sys.exit(1)
+
+    print(BANNER, file=sys.stderr)
+    print("Waiting for kernel boot...", file=sys.stderr)
+
+    try:
+        conversation = Conversation(args.history_tokens, args.truncate)
+        await Session(serial, client, conversation, cache,
+                      framing=not args.no_framing, warm=not args.no_warm,
+                      warm_cache=args.warm_cache, ack=not args.no_ack,
+                      pipeline=not args.no_pipeline,
+                      pipeline_early=args.pipeline_early, router=router_from(args)).run()
+    except ConnectionError as e:
         print(f"\nProxy shutting down. ({e})", file=sys.stderr)
     finally:
-        serial.close()
+        await serial.close()
+        if cache is not None:
+            print(f"[cache] {cache.hits} hits, {cache.misses} misses", file=sys.stderr)
+            cache.close()
+
+
+def main():
+    parser = argparse.ArgumentParser(description="PageFault Claude host proxy")
+    parser.add_argument("--port", type=int, default=4321,
+                        help="TCP port for QEMU serial (default: 4321)")
+    parser.add_argument("--host", default="127.0.0.1",
+                        help="Host for QEMU serial (default: 127.0.0.1)")
+    parser.add_argument("--pipe", action="store_true",
+                        help="Use stdin/stdout instead of TCP")
+    parser.add_argument("--shm", nargs="?", const=DEFAULT_SHM, metavar="PATH",
+                        help="Talk over the ivshmem shared-memory ring backed by "
+                             f"PATH (default: {DEFAULT_SHM})")
+    parser.add_argument("--no-api", action="store_true",
+                        help="Mock mode: echo queries instead of calling Claude")
+    parser.add_argument("--ports", metavar="LIST",
+                        help="Daemon mode: serve every guest serial port in LIST, "
+                             "e.g. 4321-4330,4400")
+    parser.add_argument("--listen", type=int, metavar="PORT",
+                        help="Daemon mode: accept guests connecting to PORT")
+    parser.add_argument("--workers", type=int, default=4,
+                        help="Daemon mode: concurrent API requests (default: 4)")
+    parser.add_argument("--rate", type=float,
+                        help="Daemon mode: global limit on API requests per second")
+    parser.add_argument("--cache", nargs="?", const=DEFAULT_CACHE, metavar="PATH",
+                        help=f"Cache answers on disk (default path: {DEFAULT_CACHE})")
+    parser.add_argument("--cache-ttl", type=float, default=7 * 24 * 3600,
+                        help="Cache entry lifetime in seconds (default: 7 days)")
+    parser.add_argument("--cache-size", type=int, default=1000,
+                        help="Maximum cached answers, LRU evicted (default: 1000)")
+    parser.add_argument("--history-tokens", type=int, default=4000,
+                        help="Token budget for conversation history (default: 4000)")
+    parser.add_argument("--truncate", choices=["oldest", "reset"], default="oldest",
+                        help="When history exceeds the budget: drop the oldest "
+                             "exchanges, or reset the conversation (default: oldest)")
+    parser.add_argument("--route", choices=["auto", "fast", "large"], default="auto",
+                        help=f"Model routing: short, simple prompts to {FAST_MODEL} "
+                             f"and the rest to {MODEL} (auto), or always one "
+                             "(default: auto)")
+    parser.add_argument("--screens", type=int, default=2,
+                        help="Output budget for long answers, in console screens "
+                             "(default: 2; short answers get one)")
+    parser.add_argument("--deadline", type=float, default=DEADLINE,
+                        help="Seconds to wait for a first chunk before asking the "
+                             f"other model instead, 0 to never (default: {DEADLINE:g})")
+    parser.add_argument("--no-framing", action="store_true",
+                        help="Always answer in text mode, even if the kernel "
+                             "advertises framing")
+    parser.add_argument("--no-ack", action="store_true",
+                        help="Have the kernel echo every answer back instead of "
+                             "acknowledging it with a length and CRC")
+    parser.add_argument("--no-pipeline", action="store_true",
+                        help="Do not let the kernel send typed-ahead queries "
+                             "before the previous answer is done")
+    parser.add_argument("--pipeline-early", action="store_true",
+                        help="Ask pipelined queries as soon as they arrive rather "
+                             "than after the answer ahead of them: faster, but "
+                             "without those exchanges as context")
+    parser.add_argument("--no-warm", action="store_true",
+                        help="Do not pre-open the API connection when the user "
+                             "starts typing after an idle period")
+    parser.add_argument("--warm-cache", action="store_true",
+                        help="Also warm the prompt cache with the conversation "
+                             "prefix while the user types (a 1-token request to "
+                             "each model --route may pick first)")
+    args = parser.parse_args()
+
+    try:
+        asyncio.run(run_proxy(args))
+    except KeyboardInterrupt:
+        print("\nProxy shutting down. (interrupted)", file=sys.stderr)
 
 
 if __name__ == "__main__":
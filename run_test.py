@@ -1,6 +1,16 @@
 #!/usr/bin/env python3
-"""End-to-end test: starts QEMU, connects to serial, drives the REPL."""
+"""End-to-end test: starts QEMU, connects to serial, drives the REPL.
 
+The first queries are answered in text mode. The rest are answered with
+binary frames, led by an ack request and an answer tag, the way
+proxy/claude_proxy.py does it: the kernel must then reply ACK:<len>,<crc>
+and send lines typed during an answer (keys injected through the QEMU
+monitor) ahead as pipelined queries.
+
+Runs under TCG; set QEMU_ACCEL=kvm to run the same test under KVM.
+"""
+
+import binascii
 import os
 import socket
 import subprocess
@@ -8,19 +18,164 @@ import sys
 import time
 
 PORT = 4322
+MONITOR_PORT = 4323
+SMP_PORT = 4324
+SMP_CPUS = 2
 KERNEL = "build/pagefault_claude"
 TIMEOUT = 15
 
+SOH = 0x01
 
-def readline(sock):
+
+def crc16(data):
+    """CRC-16/CCITT, as the kernel's crc16_update()."""
+    return binascii.crc_hqx(data, 0xFFFF)
+
+
+def frame(kind, payload=b""):
+    head = kind + len(payload).to_bytes(2, "little")
+    return bytes([SOH]) + head + crc16(head + payload).to_bytes(2, "little") + payload
+
+
+def recv_exact(sock, n):
     buf = b""
-    while True:
-        c = sock.recv(1)
+    while len(buf) < n:
+        c = sock.recv(n - len(buf))
         if not c:
             raise ConnectionError("closed")
         buf += c
-        if c == b"\n":
-            return buf.decode(errors="replace").rstrip("\n")
+    return buf
+
+
+def read_item(sock):
+    """Next line (None, text) or frame (type, payload) from the kernel."""
+    c = recv_exact(sock, 1)
+    if c[0] == SOH:
+        head = recv_exact(sock, 5)
+        payload = recv_exact(sock, int.from_bytes(head[1:3], "little"))
+        crc = int.from_bytes(head[3:5], "little")
+        assert crc == crc16(head[:3] + payload), f"bad frame CRC: {head!r}"
+        return chr(head[0]), payload
+    buf = c
+    while c != b"\n":
+        c = recv_exact(sock, 1)
+        buf += c
+    line = buf.decode(errors="replace").rstrip("\n")
+    if line.startswith("ERROR:"):   # The kernel stopped, e.g. a broken cascade
+        raise RuntimeError(f"guest stopped: {line[len('ERROR:'):]}")
+    return None, line
+
+
+def readline(sock):
+    kind, line = read_item(sock)
+    assert kind is None, f"unexpected {kind!r} frame"
+    return line
+
+
+def expect_frame(sock, kind):
+    """Skip lines (the kernel's echo of what was typed) up to a frame."""
+    while True:
+        got, data = read_item(sock)
+        if got is None:
+            print(f"  << {data}")
+            continue
+        print(f"  << frame {got} {data!r}")
+        assert got == kind, f"Expected a {kind!r} frame, got {got!r}"
+        return data
+
+
+def expect_line(sock, prefix):
+    while True:
+        line = readline(sock)
+        print(f"  << {line}")
+        if line.startswith(prefix):
+            return line[len(prefix):]
+
+
+def send_answer(sock, tag, chunks):
+    """Stream an answer the way the proxy does in ack + pipe mode."""
+    sock.sendall(frame(b"k") + frame(b"P", bytes([tag])))
+    for i, chunk in enumerate(chunks):
+        last = i == len(chunks) - 1
+        sock.sendall(frame(b"A" if last else b"a", chunk.encode()))
+
+
+def expect_ack(sock, answer):
+    ack = expect_line(sock, "ACK:")
+    data = answer.encode()
+    want = f"{len(data)},{crc16(data)}"
+    assert ack == want, f"Expected ACK:{want}, got ACK:{ack}"
+    print("  >> ACK matches")
+
+
+class Monitor:
+    """QEMU human monitor: types into the guest's PS/2 keyboard."""
+
+    KEYS = {" ": "spc", "\n": "ret"}
+
+    def __init__(self, port):
+        self.sock = socket.create_connection(("127.0.0.1", port), timeout=TIMEOUT)
+        self.prompt()
+
+    def prompt(self):
+        buf = b""
+        while not buf.endswith(b"(qemu) "):
+            c = self.sock.recv(4096)
+            if not c:
+                raise ConnectionError("monitor closed")
+            buf += c
+
+    def type(self, text):
+        for ch in text:
+            self.sock.sendall(f"sendkey {self.KEYS.get(ch, ch)}\n".encode())
+            self.prompt()
+        time.sleep(1)   # Let the guest poll them in
+
+
+def check_smp():
+    """Boot the benchmarks on SMP_CPUS vCPUs: every AP must come up through
+    INIT-SIPI-SIPI and run its own instance in the smp benchmark."""
+    qemu = subprocess.Popen(
+        [
+            "qemu-system-i386",
+            "-kernel", KERNEL,
+            "-append", "bench",
+            "-serial", f"tcp:127.0.0.1:{SMP_PORT},server=on,wait=on",
+            "-monitor", "none",
+            "-display", "none",
+            "-m", "32",
+            "-smp", str(SMP_CPUS),
+            "-device", "isa-debug-exit,iobase=0x501,iosize=0x04",
+            "-no-reboot",
+            "-accel", os.environ.get("QEMU_ACCEL", "tcg"),
+        ],
+        stdout=subprocess.DEVNULL,
+        stderr=subprocess.DEVNULL,
+    )
+    sock = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+    try:
+        for _ in range(20):
+            try:
+                sock.connect(("127.0.0.1", SMP_PORT))
+                break
+            except ConnectionRefusedError:
+                time.sleep(0.5)
+        else:
+            raise AssertionError("could not connect to the SMP guest")
+        sock.settimeout(TIMEOUT * 4)     # The benchmarks run first
+        while True:
+            line = readline(sock)
+            if line == "BENCH:done":
+                raise AssertionError("No BENCH:smp line")
+            if line.startswith("BENCH:smp cpus="):
+                print(f"  << {line}")
+                cpus = int(line.split()[1][len("cpus="):])
+                assert cpus == SMP_CPUS, f"Expected {SMP_CPUS} CPUs, {cpus} checked in"
+                return
+    finally:
+        sock.close()
+        qemu.kill()
+        qemu.wait()
 
 
 def main():
@@ -35,11 +190,12 @@ def main():
             "qemu-system-i386",
             "-kernel", KERNEL,
             "-serial", f"tcp:127.0.0.1:{PORT},server=on,wait=on",
-            "-monitor", "none",
+            "-monitor", f"tcp:127.0.0.1:{MONITOR_PORT},server=on,wait=off",
             "-display", "none",
-            "-m", "2048",
+            "-m", "32",
             "-device", "isa-debug-exit,iobase=0x501,iosize=0x04",
             "-no-reboot",
+            "-accel", os.environ.get("QEMU_ACCEL", "tcg"),
         ],
         stdout=subprocess.DEVNULL,
         stderr=subprocess.DEVNULL,
@@ -61,6 +217,7 @@ def main():
         sys.exit(1)
 
     sock.settimeout(TIMEOUT)
+    monitor = None
 
     try:
         # Wait for READY
@@ -128,8 +285,76 @@ def main():
 
         time.sleep(0.5)
 
-        # Test 4: quit
-        print("\nTEST 4: Send 'quit'")
+        # Test 4: cascade profiler
+        print("\nTEST 4: Send 'stats'")
+        sock.sendall(b"stats\n")
+        while True:
+            line = readline(sock)
+            print(f"  << {line}")
+            if line.startswith("STATS:"):
+                assert " L0 " in line, f"Expected launch label stats, got {line!r}"
+                print("  >> Got STATS")
+                break
+            elif line.startswith("Q:"):
+                print("FAIL: 'stats' was sent as a query")
+                sys.exit(1)
+
+        time.sleep(0.5)
+
+        # Test 5: the first framed answer switches the kernel to frames;
+        # led by an ack request it is not echoed, only acknowledged
+        print("\nTEST 5: Framed answer with an ack request")
+        sock.sendall(b"framed\n")
+        query = expect_line(sock, "Q:")
+        assert query == "framed", f"Expected 'framed', got {query!r}"
+        send_answer(sock, 0, ["Framed ", "answer"])
+        expect_ack(sock, "Framed answer")
+
+        # Test 6: a line typed while an answer streams is sent ahead as a
+        # pipelined query, then claimed with NEXT: once it is replayed
+        print("\nTEST 6: Typeahead is pipelined")
+        monitor = Monitor(MONITOR_PORT)
+        sock.sendall(b"again\n")
+        query = expect_frame(sock, "Q")
+        assert query == b"again", f"Expected b'again', got {query!r}"
+        sock.sendall(frame(b"k") + frame(b"P", b"\x00") + frame(b"a", b"Streaming "))
+        monitor.type("next\n")
+        piped = expect_frame(sock, "P")
+        assert piped == b"\x01next", f"Expected tag 1 'next', got {piped!r}"
+        sock.sendall(frame(b"A", b"done"))
+        expect_ack(sock, "Streaming done")
+        tag = expect_line(sock, "NEXT:")
+        assert tag == "1", f"Expected NEXT:1, got NEXT:{tag}"
+        send_answer(sock, 1, ["Pipelined answer"])
+        expect_ack(sock, "Pipelined answer")
+
+        # Test 7: a line started during an answer and finished live must
+        # not be sent again as the head of the next pipelined line
+        print("\nTEST 7: Typeahead finished live")
+        sock.sendall(b"first\n")
+        expect_frame(sock, "Q")
+        sock.sendall(frame(b"k") + frame(b"P", b"\x00") + frame(b"a", b"One "))
+        monitor.type("abc")
+        sock.sendall(frame(b"A", b"two"))
+        expect_ack(sock, "One two")
+        sock.sendall(b"xyz\n")
+        query = expect_frame(sock, "Q")
+        assert query == b"abcxyz", f"Expected b'abcxyz', got {query!r}"
+        sock.sendall(frame(b"k") + frame(b"P", b"\x00") + frame(b"a", b"Three "))
+        monitor.type("def\n")
+        piped = expect_frame(sock, "P")
+        assert piped == b"\x02def", f"Expected tag 2 'def', got {piped!r}"
+        sock.sendall(frame(b"A", b"four"))
+        expect_ack(sock, "Three four")
+        tag = expect_line(sock, "NEXT:")
+        assert tag == "2", f"Expected NEXT:2, got NEXT:{tag}"
+        send_answer(sock, 2, ["Answer to def"])
+        expect_ack(sock, "Answer to def")
+
+        time.sleep(0.5)
+
+        # Test 8: quit
+        print("\nTEST 8: Send 'quit'")
         sock.sendall(b"quit\n")
         while True:
             line = readline(sock)
@@ -138,12 +363,22 @@ def main():
                 print("  >> Got BYE")
                 break
 
+        # Test 9: APs boot and check in
+        print(f"\nTEST 9: Boot the benchmarks with -smp {SMP_CPUS}")
+        check_smp()
+        print(f"  >> All {SMP_CPUS} CPUs ran the smp benchmark")
+
         print("\n" + "=" * 50)
         print("ALL TESTS PASSED!")
         print("  - First query works (launch)")
         print("  - Second query works (resume)")
         print("  - Empty line handled")
+        print("  - Cascade stats reported")
+        print("  - Framed answers acknowledged (ACK:<len>,<crc>)")
+        print("  - Typeahead pipelined and claimed in order (NEXT:<tag>)")
+        print("  - Typeahead finished live is not piped again")
         print("  - Quit works")
+        print(f"  - {SMP_CPUS} CPUs boot and check in")
         print("  - The page fault weird machine REPL is functional!")
         print("=" * 50)
 
@@ -155,6 +390,8 @@ def main():
         sys.exit(1)
     finally:
         sock.close()
+        if monitor:
+            monitor.sock.close()
         qemu.kill()
         qemu.wait()
         print("QEMU stopped.")
@@ -0,0 +1,155 @@
+#!/usr/bin/env python3
+"""Test the cascade profiler (tools/cascade_trace.py) without QEMU.
+
+Feeds it a made-up -d int log of one REPL launch, preceded by the boot
+self-test: a smaller program in the same region whose instruction pages
+start exactly one instruction further in, so each of its tasks decodes
+as the REPL's next real instruction. Only the REPL launch may count.
+
+Usage: python3 test_cascade_trace.py
+"""
+
+import os
+import subprocess
+import sys
+import tempfile
+
+sys.path.insert(0, os.path.join(os.path.dirname(__file__), "tools"))
+import cascade_trace  # noqa: E402
+
+TRACE = os.path.join(os.path.dirname(__file__), "tools", "cascade_trace.py")
+
+BASE = 0x01000000
+GDT = 0x00800000
+FIRST_INST_PAGE = 49
+PAGES_PER_INST = 3
+
+# movdbz 0 loops through movdbz 1 until it takes z to exit; real
+# instruction 2 is the entry NOP of movdbz 0
+LAYOUT = f"""\
+# test: written by test_cascade_trace.py
+base 0x{BASE:08x}
+full_region_size 0x00e63000
+ap_region_size 0x00100000
+max_cpus 8
+gdt 0x{GDT:08x}
+gdt_window 0x10000
+first_inst_page {FIRST_INST_PAGE}
+pages_per_inst {PAGES_PER_INST}
+asm_insts 2
+real_insts 3
+inst 0 1 -1 0
+inst 1 0 0 1
+inst 2 0 0 2
+entry 0 2
+"""
+
+PF, DF = 0x0e, 0x08
+
+# (vector, REPL real instruction the task decodes as): entry NOP, movdbz
+# 0 nz, movdbz 1 nz, movdbz 0 z -> exit
+REPL_LAUNCH = [(PF, 2), (PF, 0), (PF, 1), (DF, 0)]
+
+
+def task(n, page=FIRST_INST_PAGE):
+    """CR3 of real instruction n of a program whose instructions start at page."""
+    return BASE + ((page + n * PAGES_PER_INST) << 12)
+
+
+def log_text(events):
+    """A -d int log: one exception per (vector, CR3)."""
+    out = []
+    for i, (vec, cr3) in enumerate(events):
+        out.append(f"{i:6}: v={vec:02x} e=0000 i=0 cpl=0 IP=0008:00c01000 pc=00c01000\n")
+        out.append("EAX=00000000 EBX=00000000 ECX=00000000 EDX=00000000\n")
+        out.append(f"GDT=     {GDT:08x} 0000ffff\n")
+        out.append(f"CR0=80000011 CR2=00000000 CR3={cr3:08x} CR4=00000090\n")
+    return "".join(out)
+
+
+def self_test_prefix():
+    """The self-test's instruction pages start one instruction later: its
+    task j decodes as REPL real instruction j + 1, so its task 1 looks
+    like the REPL's entry NOP. Ends mid-launch, as when the self-test's
+    last cascade is still in the log when the REPL starts."""
+    page = FIRST_INST_PAGE + PAGES_PER_INST
+    return [(PF, task(1, page)), (DF, task(0, page)), (PF, task(1, page)),
+            (PF, task(1, page))]
+
+
+def repl_launch():
+    return [(vec, task(n)) for vec, n in REPL_LAUNCH]
+
+
+def profile(layout, events):
+    p = cascade_trace.Profile(cascade_trace.Layout(layout))
+    for vec, cr3 in events:
+        p.add(vec, cr3, GDT)
+    return p
+
+
+def with_layout(test):
+    def run():
+        with tempfile.TemporaryDirectory() as d:
+            layout = os.path.join(d, "test.layout")
+            with open(layout, "w") as f:
+                f.write(LAYOUT)
+            test(d, layout)
+    return run
+
+
+@with_layout
+def test_launch(d, layout):
+    p = profile(layout, repl_launch())
+    assert dict(p.exits) == {0: [5]}, f"Expected one 5-switch launch, got {dict(p.exits)}"
+    assert (p.other, p.dropped) == (0, 0), f"other {p.other}, dropped {p.dropped}"
+
+
+@with_layout
+def test_self_test_prefix(d, layout):
+    p = profile(layout, self_test_prefix() + repl_launch())
+    assert dict(p.entries) == {0: 1}, f"Unexpected launches {dict(p.entries)}"
+    assert dict(p.exits) == {0: [5]}, f"Unexpected exits {dict(p.exits)}"
+    assert dict(p.pf) == {0: 1, 1: 1}, f"Unexpected nz branches {dict(p.pf)}"
+    assert dict(p.df) == {0: 1}, f"Unexpected z branches {dict(p.df)}"
+    assert not p.state, f"Launches left running: {list(p.state)}"
+    assert p.dropped == 3, f"Expected 3 dropped launches, got {p.dropped}"
+
+
+@with_layout
+def test_command_line(d, layout):
+    log = os.path.join(d, "cascade.log")
+    with open(log, "w") as f:
+        f.write(log_text(self_test_prefix() + repl_launch()))
+    r = subprocess.run([sys.executable, TRACE, log, "--layout", layout],
+                       capture_output=True, text=True, check=True)
+    first = r.stdout.splitlines()[0]
+    assert first.startswith("cascade switches: 5 in 1 launches"), first
+    assert "1 other exceptions, 3 launch(es) dropped" in first, first
+
+
+TESTS = [
+    ("One launch is counted", test_launch),
+    ("Self-test prefix adds no launches or branches", test_self_test_prefix),
+    ("Command line reports dropped launches", test_command_line),
+]
+
+
+def main():
+    failed = 0
+    for n, (name, test) in enumerate(TESTS, 1):
+        try:
+            test()
+        except (AssertionError, subprocess.CalledProcessError) as e:
+            print(f"TEST {n}: {name}: FAIL: {e}")
+            failed += 1
+        else:
+            print(f"TEST {n}: {name}: ok")
+    if failed:
+        print(f"\n{failed} of {len(TESTS)} tests FAILED")
+        sys.exit(1)
+    print("\nALL TESTS PASSED!")
+
+
+if __name__ == "__main__":
+    main()
@@ -9,7 +9,7 @@ Usage:
   1. Start QEMU:
        make all && qemu-system-i386 -kernel build/pagefault_claude \
          -serial tcp:127.0.0.1:4321,server=on,wait=on \
-         -display curses -m 2048 -no-reboot -no-shutdown
+         -display curses -m 32 -no-reboot -no-shutdown
   2. Run this script: python3 test_protocol.py
   3. Type queries in the QEMU window; mock responses are sent back.
 """
@@ -0,0 +1,215 @@
+#!/usr/bin/env python3
+"""Test the movdbz compiler (tools/wmc.py) without QEMU.
+
+Compiles small fixture programs and checks what the optimization passes
+leave, runs the result on a movdbz interpreter where the control flow is
+the point (countdown), and checks the errors for out-of-range constants
+and undefined labels, including through the command line.
+
+Usage: python3 test_wmc.py
+"""
+
+import os
+import subprocess
+import sys
+import tempfile
+
+sys.path.insert(0, os.path.join(os.path.dirname(__file__), "tools"))
+import wmc  # noqa: E402
+
+WMC = os.path.join(os.path.dirname(__file__), "tools", "wmc.py")
+SYMBOLS = wmc.header_symbols(wmc.HEADER)
+
+# Jumps into a loop whose only real instruction is behind a goto: the
+# back edge threads through the goto onto the decrement itself, and the
+# chain of gotos ending in a cycle must not hang the pass
+THREAD_CYCLE = """
+reg a
+a = 3
+loop
+  goto skip
+skip:
+  a = a - 1
+end
+"""
+
+JUMP_CYCLE = """
+reg a
+a = 1
+top:
+goto mid
+mid:
+goto top
+"""
+
+# Two exits, each ending in its own exit stub
+EXIT_STUBS = """
+reg a, cmd
+cmdreg cmd
+if a == 0 goto zero
+exit 1
+zero:
+exit 2
+"""
+
+# 'resume' is only reachable as an entry point, 'dead' not at all
+EXPORTS = """
+reg cmd
+cmdreg cmd
+export resume
+exit 1
+dead:
+cmd = 7
+halt
+resume:
+exit 2
+"""
+
+COUNTDOWN = """
+reg n, left
+n = {n}
+left = 1000
+countdown n
+  left = left - 1
+end
+halt
+"""
+
+
+def compile_source(text):
+    regs, consts, insts, entries, stats = wmc.compile_variant(text, dict(SYMBOLS))
+    return regs, insts, entries
+
+
+def run(insts, regs, limit=10000):
+    """Interpret movdbz: z (dest = 0) if the source is 0, else dest = source - 1."""
+    values = dict.fromkeys(regs, 0)
+    i = 0
+    for _ in range(limit):
+        inst = insts[i]
+        if inst.src == wmc.DISCARD:
+            src = 0
+        elif inst.src == wmc.ONE:
+            src = 1
+        elif isinstance(inst.src, int):
+            src = inst.src
+        else:
+            src = values[inst.src]
+        result, i = (0, inst.z) if src == 0 else (src - 1, inst.nz)
+        if inst.dst != wmc.DISCARD:
+            values[inst.dst] = result
+        if i is wmc.EXIT:
+            return values
+    raise AssertionError("program did not exit")
+
+
+def is_stub(inst):
+    return inst.dst == wmc.DISCARD and inst.nz is wmc.EXIT and inst.z is wmc.EXIT
+
+
+def expect_error(text, message):
+    try:
+        compile_source(text)
+    except wmc.CompileError as e:
+        assert message in str(e), f"Expected {message!r}, got {e}"
+        return
+    raise AssertionError(f"Expected an error containing {message!r}")
+
+
+def test_thread_cycle():
+    _, insts, _ = compile_source(THREAD_CYCLE)
+    assert len(insts) == 2, f"Expected load + decrement, got {len(insts)}"
+    dec = insts[1]
+    assert (dec.dst, dec.src) == ("a", "a"), f"Unexpected {dec.key()}"
+    assert dec.nz == dec.z == 1, f"Back edge not threaded onto itself: {dec.key()}"
+
+    # Threading stops where it would go round: the loop is kept as is
+    _, insts, _ = compile_source(JUMP_CYCLE)
+    assert [(inst.nz, inst.z) for inst in insts] == [(1, 1), (2, 2), (1, 1)], \
+        f"Jump cycle changed: {[inst.key() for inst in insts]}"
+
+
+def test_exit_stubs():
+    regs, insts, _ = compile_source(EXIT_STUBS)
+    stubs = [inst for inst in insts if is_stub(inst)]
+    assert len(stubs) == 1, f"Expected one shared exit stub, got {len(stubs)}"
+    assert len(insts) == 4, f"Expected 4 movdbz, got {len(insts)}"
+    assert run(insts, regs)["cmd"] == 2, "a == 0 should exit with command 2"
+
+
+def test_exports():
+    regs, insts, entries = compile_source(EXPORTS)
+    assert set(entries) == {"resume"}, f"Unexpected entries {entries}"
+    resume = insts[entries["resume"]]
+    assert (resume.dst, resume.src) == ("cmd", 3), f"Export lost: {resume.key()}"
+    assert all(inst.src != 8 for inst in insts), "Unreachable 'cmd = 7' was kept"
+    assert len(insts) == 3, f"Expected 3 movdbz, got {len(insts)}"
+
+
+def test_countdown():
+    for n in (0, 1, 5, 300):
+        regs, insts, _ = compile_source(COUNTDOWN.format(n=n))
+        values = run(insts, regs)
+        trips = 1000 - values["left"]
+        assert trips == n, f"countdown {n} ran its body {trips} times"
+        assert values["n"] == 0, f"countdown {n} left n = {values['n']}"
+
+
+def test_errors():
+    compile_source(f"reg a\na = {wmc.MAX_VALUE}\nhalt\n")
+    expect_error("reg a\na = 1024\nhalt\n", f"constant 1024 out of range 0..{wmc.MAX_VALUE}")
+    expect_error("reg a\nfuel 2000\nhalt\n", "out of range")
+    expect_error("goto nowhere\n", "line 1: unknown label 'nowhere'")
+    expect_error("reg a\nif a != 0 goto later\nhalt\n", "line 2: unknown label 'later'")
+    expect_error("export resume\nhalt\n", "exported label 'resume' is not defined")
+
+
+def test_command_line():
+    with tempfile.TemporaryDirectory() as d:
+        src = os.path.join(d, "bad.wm")
+        with open(src, "w") as f:
+            f.write("reg a\na = 4096\nhalt\n")
+        out = os.path.join(d, "bad.h")
+        r = subprocess.run([sys.executable, WMC, src, "-o", out, "--name", "bad"],
+                           capture_output=True, text=True)
+        assert r.returncode == 1, f"Expected exit status 1, got {r.returncode}"
+        assert "error: line 2: constant 4096 out of range" in r.stderr, r.stderr
+        assert not os.path.exists(out), "Header written despite the error"
+
+        with open(src, "w") as f:
+            f.write(EXIT_STUBS)
+        subprocess.run([sys.executable, WMC, src, "-o", out, "--name", "ok"], check=True)
+        with open(out) as f:
+            header = f.read()
+        assert "5 -> 4 movdbz after optimization" in header, header
+        assert "static const struct wm_program ok_program" in header, header
+
+
+TESTS = [
+    ("Jump threading through cycles", test_thread_cycle),
+    ("Exit stubs are merged", test_exit_stubs),
+    ("Exports stay alive, dead code goes", test_exports),
+    ("countdown runs its body N times", test_countdown),
+    ("MAX_VALUE and undefined labels are errors", test_errors),
+    ("Command line reports errors", test_command_line),
+]
+
+
+def main():
+    failed = 0
+    for n, (name, test) in enumerate(TESTS, 1):
+        try:
+            test()
+        except (AssertionError, wmc.CompileError) as e:
+            print(f"TEST {n}: {name}: FAIL: {e}")
+            failed += 1
+        else:
+            print(f"TEST {n}: {name}: ok")
+    if failed:
+        print(f"\n{failed} of {len(TESTS)} tests FAILED")
+        sys.exit(1)
+    print("\nALL TESTS PASSED!")
+
+
+if __name__ == "__main__":
+    main()
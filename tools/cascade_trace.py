@@ -0,0 +1,286 @@
+#!/usr/bin/env python3
+"""cascade_trace - profile fault cascades from a QEMU interrupt log.
+
+Nothing inside a cascade can be instrumented, since no instructions run,
+but QEMU under TCG logs every exception it delivers with -d int, together
+with the CPU state of the task it was delivered in. Every real
+instruction runs in its own task with its own page directory, so CR3
+names the instruction; GDTR names the weird machine instance (each has
+its own 64KB GDT window); and the vector names the branch:
+
+  v=0e  #PF: the entry push succeeded, the instruction took its nz branch
+  v=08  #DF: the entry push faulted, the instruction took its z branch
+
+One logged exception is one task switch. A launch is the run of switches
+from the entry NOP to the instruction that branches to exit (-1), plus
+the ljmp that entered it. The page layout comes from the .layout files
+tools/wmimage.c writes next to each prebuilt image; movdbz listings are
+taken from the comments wmc.py writes into the program header.
+
+Reports hot movdbz instructions with their branch ratios, the NOP
+switches slot assignment added after each, and switches per bridge exit.
+Other programs run in the same region (the boot self-test) can decode
+as instructions of the layout; a launch is only counted if every switch
+lands where the one before branched to, so theirs are dropped.
+--folded writes "cpu;entry;movdbz;..." stacks with switch counts, the
+input format of flamegraph.pl.
+
+Usage:
+  make trace    (runs QEMU with -d int, then this on build/cascade.log)
+  python3 tools/cascade_trace.py build/cascade.log \\
+      --layout build/repl_byte.layout --program build/repl_prog.h
+"""
+
+import argparse
+import re
+import sys
+from collections import Counter, defaultdict
+
+EVENT = re.compile(r"^\s*\d+: v=([0-9a-f]{2}) ")
+CR3 = re.compile(r"\bCR3=([0-9a-f]+)")
+GDT = re.compile(r"^GDT=\s*([0-9a-f]+)")
+
+VEC_PF = 0x0e
+VEC_DF = 0x08
+
+
+class Layout:
+    """Where wm_generate() put each real instruction (a wmimage .layout)."""
+
+    def __init__(self, path, mem_mb=32):
+        self.name = path
+        self.insts = {}         # real instruction -> (nz, z)
+        self.entry_of = {}      # entry NOP -> movdbz it enters
+        fields = {}
+        with open(path) as f:
+            for line in f:
+                words = line.split("#", 1)[0].split()
+                if not words:
+                    continue
+                if words[0] == "inst":
+                    n, nz, z = (int(x) for x in words[1:4])
+                    self.insts[n] = (nz, z)
+                elif words[0] == "entry":
+                    self.entry_of[int(words[2])] = int(words[1])
+                else:
+                    fields[words[0]] = int(words[1], 0)
+        self.base = fields["base"]
+        self.ap_region_size = fields["ap_region_size"]
+        # Instance 0's region is sized from RAM by wm_setup(), the others
+        # are stacked down from where the regions end
+        aps = (fields["max_cpus"] - 1) * self.ap_region_size
+        room = (mem_mb << 20) - self.base - aps
+        self.region_end = self.base + min(fields["full_region_size"], room) + aps
+        self.gdt = fields["gdt"]
+        self.gdt_window = fields["gdt_window"]
+        self.first_inst_page = fields["first_inst_page"]
+        self.pages_per_inst = fields["pages_per_inst"]
+        self.asm_insts = fields["asm_insts"]
+
+    def decode(self, cr3, gdt):
+        """(instance, real instruction) of a task, or None outside the program."""
+        if gdt is None or gdt < self.gdt:
+            return None
+        cpu = (gdt - self.gdt) // self.gdt_window
+        base = self.base if cpu == 0 else self.region_end - cpu * self.ap_region_size
+        page = (cr3 - base) >> 12
+        n, off = divmod(page - self.first_inst_page, self.pages_per_inst)
+        if off != 0 or n not in self.insts:
+            return None
+        return cpu, n
+
+
+def read_listing(path, name):
+    """movdbz n -> source text, from the comment wmc.py writes per program."""
+    listing = {}
+    inside = False
+    head = re.compile(r"/\* " + re.escape(name) + r": ")
+    line_re = re.compile(r"^\s*\*\s+(\d+): (.*)$")
+    with open(path) as f:
+        for line in f:
+            if head.match(line):
+                inside = True
+            elif inside:
+                m = line_re.match(line)
+                if not m:
+                    break
+                listing[int(m.group(1))] = m.group(2).strip()
+    return listing
+
+
+def read_events(path):
+    """Yield (vector, CR3, GDT base) for each exception in a -d int log."""
+    vec = cr3 = gdt = None
+    with open(path, errors="replace") as f:
+        for line in f:
+            m = EVENT.match(line)
+            if m:
+                if vec is not None and cr3 is not None:
+                    yield vec, cr3, gdt
+                vec, cr3, gdt = int(m.group(1), 16), None, None
+                continue
+            if vec is None:
+                continue
+            m = CR3.search(line)
+            if m:
+                cr3 = int(m.group(1), 16)
+            m = GDT.match(line)
+            if m:
+                gdt = int(m.group(1), 16)
+    if vec is not None and cr3 is not None:
+        yield vec, cr3, gdt
+
+
+class Launch:
+    """Counts of one launch, kept apart until it exits."""
+
+    def __init__(self, cpu, entry):
+        self.cpu = cpu
+        self.entry = entry
+        self.last = None                # Last movdbz run
+        self.expect = None              # Real instruction branched to
+        self.switches = 2               # The entry NOP and the ljmp into it
+        self.pf = Counter()
+        self.df = Counter()
+        self.nops = Counter()
+        self.folded = Counter({f"cpu{cpu};entry {entry};entry nop": 2})
+
+
+class Profile:
+    def __init__(self, layout):
+        self.layout = layout
+        self.pf = Counter()             # movdbz -> nz branches
+        self.df = Counter()             # movdbz -> z branches
+        self.nops = Counter()           # movdbz -> NOP switches after it
+        self.entries = Counter()        # movdbz -> launches entered there
+        self.exits = defaultdict(list)  # movdbz -> switches of each launch
+        self.folded = Counter()
+        self.other = 0                  # Exceptions outside the program
+        self.dropped = 0                # Launches that left the layout's branches
+        self.cut = 0                    # Launches the log ends inside
+        self.state = {}                 # cpu -> running Launch
+
+    def add(self, vec, cr3, gdt):
+        where = self.layout.decode(cr3, gdt) if vec in (VEC_PF, VEC_DF) else None
+        if where is None:
+            self.other += 1
+            return
+        cpu, n = where
+        nz, z = self.layout.insts[n]
+        target = nz if vec == VEC_PF else z
+        launch = self.state.get(cpu)
+
+        if launch is not None and n != launch.expect:
+            # Not what the last switch branched to: another program's
+            # tasks that alias the layout (or pages the log skipped)
+            del self.state[cpu]
+            self.dropped += 1
+            launch = None
+
+        if launch is None:
+            if n not in self.layout.entry_of:
+                self.other += 1         # Not the start of a launch
+                return
+            # Entry NOP (which may double as a branch NOP mid-launch)
+            launch = self.state[cpu] = Launch(cpu, self.layout.entry_of[n])
+        else:
+            launch.switches += 1
+            stack = f"cpu{cpu};entry {launch.entry};movdbz "
+            if n < self.layout.asm_insts:
+                launch.last = n
+                (launch.pf if vec == VEC_PF else launch.df)[n] += 1
+                launch.folded[f"{stack}{n}"] += 1
+            else:
+                launch.nops[launch.last] += 1
+                launch.folded[f"{stack}{launch.last};nop"] += 1
+
+        if target < 0:
+            del self.state[cpu]
+            self.finish(launch, n)
+        else:
+            launch.expect = target
+
+    def finish(self, launch, n):
+        """Count a launch that exited at real instruction n."""
+        self.pf.update(launch.pf)
+        self.df.update(launch.df)
+        self.nops.update(launch.nops)
+        self.folded.update(launch.folded)
+        self.entries[launch.entry] += 1
+        self.exits[n].append(launch.switches)
+
+    def report(self, out, listing, top):
+        runs = Counter({n: self.pf[n] + self.df[n] for n in set(self.pf) | set(self.df)})
+        total = sum(runs.values()) + sum(self.nops.values()) + 2 * sum(self.entries.values())
+        launches = sum(len(v) for v in self.exits.values())
+        self.cut = len(self.state)
+        w = out.write
+
+        w(f"cascade switches: {total} in {launches} launches "
+          f"({total / launches if launches else 0:.1f} per launch), "
+          f"{self.other} other exceptions")
+        if self.dropped:
+            w(f", {self.dropped} launch(es) dropped off the layout's branches")
+        w(f", {self.cut} launch(es) cut off by the end of the log\n" if self.cut else "\n")
+
+        w("\nHot movdbz instructions\n")
+        w(f"  {'movdbz':>6} {'runs':>9} {'share':>6} {'nz':>9} {'z':>9} "
+          f"{'z%':>6} {'nops':>8}  source\n")
+        for n, count in runs.most_common(top):
+            share = 100.0 * count / total if total else 0
+            zpct = 100.0 * self.df[n] / count
+            w(f"  {n:>6} {count:>9} {share:>5.1f}% {self.pf[n]:>9} {self.df[n]:>9} "
+              f"{zpct:>5.1f}% {self.nops[n]:>8}  {listing.get(n, '')}\n")
+
+        w("\nSwitches per bridge exit\n")
+        w(f"  {'exit at':>7} {'launches':>9} {'min':>6} {'avg':>8} {'max':>6}  source\n")
+        for n in sorted(self.exits, key=lambda n: -len(self.exits[n])):
+            sw = self.exits[n]
+            w(f"  {n:>7} {len(sw):>9} {min(sw):>6} {sum(sw) / len(sw):>8.1f} "
+              f"{max(sw):>6}  {listing.get(n, '')}\n")
+
+        w("\nLaunches per entry point\n")
+        for n, count in self.entries.most_common():
+            w(f"  movdbz {n}: {count}\n")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="QEMU -d int cascade profiler")
+    parser.add_argument("log", help="QEMU log written with -d int -D <log>")
+    parser.add_argument("--layout", required=True,
+                        help="Program layout from tools/wmimage.c (build/<name>.layout)")
+    parser.add_argument("--mem", type=int, default=32,
+                        help="Guest RAM in MB (QEMU -m), which places the regions")
+    parser.add_argument("--program", help="wmc.py header with the program's listing")
+    parser.add_argument("--name", help="Program name in the header "
+                                       "(default: the layout file's name)")
+    parser.add_argument("--top", type=int, default=20, help="Hot instructions to list")
+    parser.add_argument("--folded", help="Write folded stacks for flamegraph.pl")
+    args = parser.parse_args()
+
+    try:
+        layout = Layout(args.layout, args.mem)
+    except (OSError, KeyError, ValueError) as e:
+        print(f"{args.layout}: bad layout ({e})", file=sys.stderr)
+        return 1
+    name = args.name or re.sub(r"\.layout$", "", args.layout.rsplit("/", 1)[-1])
+    listing = read_listing(args.program, name) if args.program else {}
+
+    profile = Profile(layout)
+    try:
+        for event in read_events(args.log):
+            profile.add(*event)
+    except OSError as e:
+        print(f"{args.log}: {e}", file=sys.stderr)
+        return 1
+
+    profile.report(sys.stdout, listing, args.top)
+    if args.folded:
+        with open(args.folded, "w") as f:
+            for stack, count in sorted(profile.folded.items()):
+                f.write(f"{stack} {count}\n")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
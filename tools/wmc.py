@@ -0,0 +1,436 @@
+#!/usr/bin/env python3
+"""wmc - movdbz compiler for the page fault weird machine.
+
+Compiles a small structured language to movdbz instructions and emits a
+C header with a `struct wm_program` table per variant, loaded at boot by
+wm_load_program(). Writing weird-machine programs this way replaces
+hand-numbered wm_gen_movdbz() calls and the "constant must be value + 1"
+bookkeeping.
+
+Language (one statement per line, '#' or ';' starts a comment):
+
+  reg a, b, c             user registers r0, r1, ... in declaration order
+  cmdreg a                register that `exit` writes the command code to
+  fuel N                  opt in to bounded execution: wm_load_program()
+                          exits with WM_IO_OUT_OF_FUEL after N backward
+                          branches in one resume (needs a 'cmdreg')
+  export name             label the bridge may resume at (entry point)
+  name:                   label the next statement
+  a = N                   load a constant (N may be a WM_* name from
+                          weirdmachine.h or a -D parameter)
+  a = b - 1               decrement (both outcomes fall through)
+  goto name
+  if a == 0 goto name     branch on a register (a is not modified)
+  if a != 0 goto name
+  exit N                  cmdreg = N, then leave the weird machine; the
+                          bridge resumes at an exported label
+  halt                    leave the weird machine
+  loop / end              repeat the body forever
+  countdown a / end       run the body a times, counting a down to 0
+  movdbz d, s, nz, z      raw instruction; targets are labels, `next`
+                          or `exit`; d and s may be `_` (discard)
+
+Optimization passes, in order: constant interning, jump threading over
+pure jumps (discarded destination, both paths to the same place, or a
+constant source), merging of identical instructions (exit stubs), and
+elimination of instructions unreachable from the start or an export.
+
+Usage:
+  python3 tools/wmc.py kernel/repl.wm -o build/repl_prog.h --name repl \\
+      --variant byte:READ=WM_IO_READ_BYTE --variant line:READ=WM_IO_READ_LINE
+"""
+
+import argparse
+import os
+import re
+import sys
+
+DISCARD = "_"
+ONE = "#1"          # Built-in constant-one register (WM_REG_CONST_ONE)
+EXIT = None         # Branch target: leave the weird machine
+MAX_VALUE = 1023    # Stored as value + 1 <= 1024 (ESP on a 4KB stack page)
+
+HEADER = os.path.join(os.path.dirname(__file__), "..", "kernel", "weirdmachine.h")
+
+
+class CompileError(Exception):
+    pass
+
+
+class Inst:
+    """movdbz dst, src, nz, z. src is a register name, DISCARD, or an
+    int (a constant's stored value). Targets are instruction indices,
+    labels (before resolution), "next" or EXIT."""
+
+    def __init__(self, dst, src, nz, z, line):
+        self.dst, self.src, self.nz, self.z = dst, src, nz, z
+        self.line = line
+
+    def key(self):
+        return (self.dst, self.src, self.nz, self.z)
+
+    def is_jump(self):
+        """Pure jump: no visible write and a fixed successor."""
+        if self.dst != DISCARD:
+            return False
+        if self.nz == self.z:
+            return self.nz is not EXIT
+        constant = isinstance(self.src, int) or self.src == ONE
+        return constant and self.nz is not EXIT
+
+
+def header_symbols(path):
+    syms = {}
+    with open(path) as f:
+        for m in re.finditer(r"^#define\s+(WM_\w+)\s+\(?(-?\d+)\)?", f.read(), re.M):
+            syms[m.group(1)] = int(m.group(2))
+    return syms
+
+
+class Parser:
+    def __init__(self, text, symbols):
+        self.symbols = symbols
+        self.regs = []
+        self.cmdreg = None
+        self.fuel = 0
+        self.exports = []
+        self.insts = []
+        self.labels = {}
+        self.blocks = []        # (kind, top label, end label, line)
+        self.pending = []       # Labels waiting for the next instruction
+        self.gensym = 0
+        self.text = text
+
+    def error(self, line, msg):
+        raise CompileError(f"line {line}: {msg}")
+
+    def value(self, word, line):
+        if re.fullmatch(r"-?\d+", word):
+            v = int(word)
+        elif word in self.symbols:
+            v = self.symbols[word]
+        else:
+            self.error(line, f"unknown constant '{word}'")
+        if not 0 <= v <= MAX_VALUE:
+            self.error(line, f"constant {v} out of range 0..{MAX_VALUE}")
+        return v
+
+    def reg(self, word, line, discard=False):
+        if discard and word == DISCARD:
+            return DISCARD
+        if word not in self.regs:
+            self.error(line, f"unknown register '{word}'")
+        return word
+
+    def label(self, name, line):
+        if name in self.labels or name in self.pending:
+            self.error(line, f"duplicate label '{name}'")
+        self.pending.append(name)
+
+    def new_label(self):
+        self.gensym += 1
+        return f".L{self.gensym}"
+
+    def emit(self, dst, src, nz, z, line):
+        for name in self.pending:
+            self.labels[name] = len(self.insts)
+        self.pending = []
+        self.insts.append(Inst(dst, src, nz, z, line))
+
+    def emit_exit_stub(self, line):
+        self.emit(DISCARD, DISCARD, EXIT, EXIT, line)
+
+    def target(self, word, line):
+        if word == "exit":
+            return EXIT
+        if word == "next":
+            return "next"
+        if not re.fullmatch(r"[A-Za-z_.]\w*", word):
+            self.error(line, f"bad label '{word}'")
+        return word
+
+    def parse(self):
+        for n, raw in enumerate(self.text.splitlines(), 1):
+            text = re.split(r"[#;]", raw, maxsplit=1)[0].strip()
+            if text:
+                self.statement(text, n)
+        if self.blocks:
+            self.error(self.blocks[-1][3], f"'{self.blocks[-1][0]}' without 'end'")
+        if self.pending:
+            self.error(n, f"label '{self.pending[0]}' at end of program")
+        return self
+
+    def statement(self, s, n):
+        words = s.replace(",", " ").split()
+        op = words[0]
+
+        if re.fullmatch(r"[A-Za-z_]\w*:", s):
+            self.label(s[:-1], n)
+        elif op == "reg":
+            for w in words[1:]:
+                if w in self.regs:
+                    self.error(n, f"register '{w}' declared twice")
+                self.regs.append(w)
+        elif op == "cmdreg" and len(words) == 2:
+            self.cmdreg = self.reg(words[1], n)
+        elif op == "fuel" and len(words) == 2:
+            self.fuel = self.value(words[1], n)
+            if not self.fuel:
+                self.error(n, "'fuel' must be at least 1")
+        elif op == "export" and len(words) >= 2:
+            self.exports += words[1:]
+        elif op == "goto" and len(words) == 2:
+            self.emit(DISCARD, DISCARD, self.target(words[1], n),
+                      self.target(words[1], n), n)
+        elif op == "if":
+            m = re.fullmatch(r"if\s+(\w+)\s*([!=]=)\s*0\s+goto\s+(\S+)", s)
+            if not m:
+                self.error(n, "expected 'if REG == 0 goto L' or 'if REG != 0 goto L'")
+            src = self.reg(m.group(1), n)
+            to = self.target(m.group(3), n)
+            if m.group(2) == "==":
+                self.emit(DISCARD, src, "next", to, n)
+            else:
+                self.emit(DISCARD, src, to, "next", n)
+        elif op == "exit" and len(words) == 2:
+            if self.cmdreg is None:
+                self.error(n, "'exit' needs a 'cmdreg'")
+            self.emit(self.cmdreg, self.value(words[1], n) + 1, "next", "next", n)
+            self.emit_exit_stub(n)
+        elif op == "halt" and len(words) == 1:
+            self.emit_exit_stub(n)
+        elif op == "loop" and len(words) == 1:
+            top = self.new_label()
+            self.label(top, n)
+            self.blocks.append(("loop", top, None, n))
+        elif op == "countdown" and len(words) == 2:
+            r = self.reg(words[1], n)
+            top, done = self.new_label(), self.new_label()
+            self.label(top, n)
+            self.emit(r, r, "next", done, n)
+            self.blocks.append(("countdown", top, done, n))
+        elif op == "end" and len(words) == 1:
+            if not self.blocks:
+                self.error(n, "'end' without a block")
+            _, top, done, _ = self.blocks.pop()
+            self.emit(DISCARD, DISCARD, top, top, n)
+            if done:
+                self.label(done, n)
+        elif op == "movdbz" and len(words) == 5:
+            dst = self.reg(words[1], n, discard=True)
+            src = self.reg(words[2], n, discard=True)
+            self.emit(dst, src, self.target(words[3], n), self.target(words[4], n), n)
+        elif len(words) >= 3 and words[1] == "=":
+            dst = self.reg(words[0], n)
+            if len(words) == 5 and words[3] == "-" and words[4] == "1":
+                self.emit(dst, self.reg(words[2], n), "next", "next", n)
+            elif len(words) == 3:
+                self.emit(dst, self.value(words[2], n) + 1, "next", "next", n)
+            else:
+                self.error(n, "expected 'REG = N' or 'REG = REG - 1'")
+        else:
+            self.error(n, f"cannot parse '{s}'")
+
+
+def resolve(p):
+    """Turn label/next targets into instruction indices."""
+    for i, inst in enumerate(p.insts):
+        for attr in ("nz", "z"):
+            t = getattr(inst, attr)
+            if t == "next":
+                if i + 1 >= len(p.insts):
+                    raise CompileError(f"line {inst.line}: falls off the end of the program")
+                t = i + 1
+            elif isinstance(t, str):
+                if t not in p.labels:
+                    raise CompileError(f"line {inst.line}: unknown label '{t}'")
+                t = p.labels[t]
+            setattr(inst, attr, t)
+    for name in p.exports:
+        if name not in p.labels:
+            raise CompileError(f"exported label '{name}' is not defined")
+    return {name: p.labels[name] for name in p.exports}
+
+
+def optimize(insts, exports):
+    """Run the passes; returns (instructions, exports, stats)."""
+    stats = {"input": len(insts)}
+    insts = list(insts)
+    entries = dict(exports)
+    start = 0
+
+    # Constant interning: a stored value of 1 is the built-in register
+    for inst in insts:
+        if inst.src == 1:
+            inst.src = ONE
+
+    def redirect(fn):
+        nonlocal start
+        for inst in insts:
+            if inst.nz is not EXIT:
+                inst.nz = fn(inst.nz)
+            if inst.z is not EXIT:
+                inst.z = fn(inst.z)
+        for name in entries:
+            entries[name] = fn(entries[name])
+        start = fn(start)
+
+    changed = True
+    while changed:
+        changed = False
+
+        # Jump threading
+        def thread(i):
+            seen = set()
+            while insts[i].is_jump() and i not in seen:
+                seen.add(i)
+                i = insts[i].nz
+            return i
+        before = [(inst.nz, inst.z) for inst in insts]
+        redirect(thread)
+        changed |= before != [(inst.nz, inst.z) for inst in insts]
+
+        # Merge identical instructions (exit stubs in particular)
+        first = {}
+        alias = {}
+        for i, inst in enumerate(insts):
+            alias[i] = first.setdefault(inst.key(), i)
+        if any(alias[i] != i for i in alias):
+            redirect(lambda i: alias[i])
+
+        # Dead-instruction elimination
+        live = set()
+        work = [start] + list(entries.values())
+        while work:
+            i = work.pop()
+            if i in live:
+                continue
+            live.add(i)
+            work += [t for t in (insts[i].nz, insts[i].z) if t is not EXIT]
+
+        # Renumber: start first, then the original order
+        order = [start] + [i for i in range(len(insts)) if i in live and i != start]
+        if order != list(range(len(insts))):
+            changed = True
+            index = {old: new for new, old in enumerate(order)}
+            insts = [insts[i] for i in order]
+            redirect(lambda i: index[i])
+    stats["output"] = len(insts)
+    return insts, entries, stats
+
+
+def compile_variant(text, symbols):
+    p = Parser(text, symbols).parse()
+    if not p.insts:
+        raise CompileError("empty program")
+    if p.fuel and p.cmdreg is None:
+        raise CompileError("'fuel' needs a 'cmdreg'")
+    exports = resolve(p)
+    insts, entries, stats = optimize(p.insts, exports)
+
+    consts = []
+    for inst in insts:
+        if isinstance(inst.src, int) and inst.src not in consts:
+            consts.append(inst.src)
+    stats["cmdreg"] = p.regs.index(p.cmdreg) if p.cmdreg else -1
+    stats["fuel"] = p.fuel
+    return p.regs, consts, insts, entries, stats
+
+
+def operand(x, regs, consts):
+    if x == DISCARD:
+        return "WM_REG_DISCARD"
+    if x == ONE:
+        return "WM_REG_CONST_ONE"
+    if isinstance(x, int):
+        return f"WM_REG_CONST({consts.index(x)})"
+    return str(regs.index(x))
+
+
+def show(x):
+    if x is EXIT:
+        return "exit"
+    return str(x)
+
+
+def emit_header(out, source, name, variants):
+    up = name.upper()
+    guard = f"{up}_PROG_H"
+    w = out.write
+    w(f"/* Generated by tools/wmc.py from {source} -- do not edit. */\n\n")
+    w(f"#ifndef {guard}\n#define {guard}\n\n#include \"weirdmachine.h\"\n\n")
+
+    regs, _, insts, entries, _ = variants[0][1]
+    for i, r in enumerate(regs):
+        w(f"#define {up}_REG_{r.upper()} {i}\n")
+    for label, i in entries.items():
+        w(f"#define {up}_{label.upper()} {i}\n")
+    w(f"#define {up}_NUM_INSTS {len(insts)}\n")
+
+    for vname, (regs, consts, insts, _, stats) in variants:
+        sym = f"{name}_{vname}" if vname else name
+        w(f"\n/* {sym}: {stats['input']} -> {stats['output']} movdbz after optimization\n")
+        for i, inst in enumerate(insts):
+            src = f"={inst.src - 1}" if isinstance(inst.src, int) else inst.src
+            w(f" *   {i:3}: movdbz {inst.dst}, {src}, {show(inst.nz)}, {show(inst.z)}\n")
+        w(" */\n")
+        if consts:
+            w(f"static const uint32_t {sym}_consts[] = {{ {', '.join(map(str, consts))} }};\n")
+        w(f"static const struct wm_inst {sym}_insts[] = {{\n")
+        for inst in insts:
+            nz = -1 if inst.nz is EXIT else inst.nz
+            z = -1 if inst.z is EXIT else inst.z
+            w(f"    {{ {operand(inst.dst, regs, consts)}, {operand(inst.src, regs, consts)},"
+              f" {nz}, {z} }},\n")
+        w("};\n")
+        w(f"static const struct wm_program {sym}_program = {{\n")
+        w(f"    {len(regs)}, {len(consts)}, {sym + '_consts' if consts else '0'},\n")
+        w(f"    {len(insts)}, {sym}_insts,\n")
+        w(f"    {stats['cmdreg']}, {stats['fuel']},\n}};\n")
+    w(f"\n#endif /* {guard} */\n")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="movdbz compiler")
+    parser.add_argument("source")
+    parser.add_argument("-o", "--output", required=True)
+    parser.add_argument("--name", required=True, help="C symbol prefix")
+    parser.add_argument("--variant", action="append", default=[],
+                        metavar="NAME:SYM=VAL,...",
+                        help="Compile once per variant with these parameters")
+    parser.add_argument("-D", dest="defines", action="append", default=[],
+                        metavar="SYM=VAL", help="Parameter for every variant")
+    args = parser.parse_args()
+
+    symbols = header_symbols(HEADER)
+
+    def define(d, syms):
+        k, _, v = d.partition("=")
+        syms[k] = syms[v] if v in syms else int(v, 0)
+
+    try:
+        for d in args.defines:
+            define(d, symbols)
+        with open(args.source) as f:
+            text = f.read()
+        specs = args.variant or [""]
+        variants = []
+        for spec in specs:
+            vname, _, defs = spec.partition(":")
+            syms = dict(symbols)
+            for d in filter(None, defs.split(",")):
+                define(d, syms)
+            variants.append((vname, compile_variant(text, syms)))
+        layout = {(tuple(v[0]), len(v[2]), tuple(v[3].items())) for _, v in variants}
+        if len(layout) != 1:
+            raise CompileError("variants differ in registers, size or entry points")
+    except (CompileError, ValueError, KeyError) as e:
+        print(f"{args.source}: error: {e}", file=sys.stderr)
+        sys.exit(1)
+
+    with open(args.output, "w") as out:
+        emit_header(out, args.source, args.name, variants)
+
+
+if __name__ == "__main__":
+    main()
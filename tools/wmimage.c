@@ -0,0 +1,140 @@
+/*
+ * wmimage - build prebuilt weird machine program images on the host.
+ *
+ * Compiles the engine itself (kernel/weirdmachine.c with WM_HOSTGEN) and
+ * runs wm_load_program() for each compiled program in repl_prog.h over a
+ * host buffer standing in for the program region. Every PD, page table,
+ * IDT page and TSS head therefore comes from the same code the kernel
+ * would run at boot.
+ *
+ * Writes <out>.h with one struct wm_image per program, and the raw
+ * pages as <dir>/<name>.img for diffing and checksumming. <dir>/<name>.layout
+ * describes where each real instruction's pages ended up, for decoding
+ * cascade traces (tools/cascade_trace.py).
+ *
+ * Usage: wmimage <out.h> <dir>
+ */
+
+#define WM_HOSTGEN
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "weirdmachine.c"
+#include "repl_prog.h"
+
+static const struct {
+    const char *name;
+    const struct wm_program *prog;
+} programs[] = {
+    { "repl_byte", &repl_byte_program },
+    { "repl_line", &repl_line_program },
+};
+
+static int write_raw(const char *dir, const char *name, uint32_t pages) {
+    struct wm_ctx *w = self();
+    char path[512];
+    snprintf(path, sizeof(path), "%s/%s.img", dir, name);
+    FILE *f = fopen(path, "wb");
+    if (!f) return -1;
+    size_t n = fwrite(PAGE2VIRT(w, 0), 4096, pages, f);
+    return fclose(f) == 0 && n == pages ? 0 : -1;
+}
+
+/*
+ * Text layout: region addresses, then one "inst <n> <nz> <z> <slot>" line
+ * per real instruction (n < asm_insts is movdbz n, the rest are NOPs) and
+ * one "entry <movdbz> <n>" line per entry NOP. Each real instruction's
+ * page directory, which is the CR3 of its task, sits at page
+ * first_inst_page + n * pages_per_inst of the region.
+ */
+static int write_layout(const char *dir, const char *name) {
+    struct wm_ctx *w = self();
+    char path[512];
+    snprintf(path, sizeof(path), "%s/%s.layout", dir, name);
+    FILE *f = fopen(path, "w");
+    if (!f) return -1;
+
+    fprintf(f, "# %s: generated by tools/wmimage.c -- do not edit\n", name);
+    fprintf(f, "base 0x%08x\nfull_region_size 0x%08x\n", w->base, w->pages << 12);
+    fprintf(f, "ap_region_size 0x%08x\nmax_cpus %d\n", AP_REGION_SIZE, WM_MAX_CPUS);
+    fprintf(f, "gdt 0x%08x\ngdt_window 0x%x\n", GDT_ADDRESS, GDT_WINDOW);
+    fprintf(f, "first_inst_page %d\npages_per_inst %d\n",
+            w->first_inst_page, PAGES_PER_INST);
+    fprintf(f, "asm_insts %d\nreal_insts %d\n", w->num_asm_insts, w->num_real_insts);
+    for (int i = 0; i < w->num_real_insts; i++)
+        fprintf(f, "inst %d %d %d %d\n", i, w->insts[i].nz, w->insts[i].z,
+                w->insts[i].slot);
+    for (int i = 0; i < w->num_asm_insts; i++)
+        fprintf(f, "entry %d %d\n", i, w->entry_inst[i]);
+    return fclose(f);
+}
+
+static void write_image(FILE *out, const char *name) {
+    struct wm_ctx *w = self();
+    uint32_t pages = image_pages(w);
+    uint32_t state[WM_STATE_WORDS];
+    const uint32_t *p = PAGE2VIRT(w, 0);
+    uint32_t n = pages * 1024;
+
+    save_state(w, state);
+
+    fprintf(out, "\nstatic const uint32_t %s_image_state[] = {", name);
+    for (int i = 0; i < WM_STATE_WORDS; i++)
+        fprintf(out, "%s0x%x,", i % 8 ? " " : "\n    ", state[i]);
+    fprintf(out, "\n};\n");
+
+    /* Maximal runs of non-zero dwords */
+    fprintf(out, "static const uint32_t %s_image_runs[] = {\n", name);
+    for (uint32_t i = 0; i < n; ) {
+        if (!p[i]) { i++; continue; }
+        uint32_t len = 0;
+        while (i + len < n && p[i + len]) len++;
+        fprintf(out, "    0x%05x, %u,", i, len);
+        for (uint32_t k = 0; k < len; k++)
+            fprintf(out, " 0x%x,", p[i + k]);
+        fprintf(out, "\n");
+        i += len;
+    }
+    fprintf(out, "    0, 0,\n};\n");
+
+    fprintf(out, "static const struct wm_image %s_image = {\n", name);
+    fprintf(out, "    WM_IMAGE_VERSION, %u, 0x%08x, %d,\n",
+            pages, wm_image_checksum(), WM_STATE_WORDS);
+    fprintf(out, "    %s_image_state, %s_image_runs,\n};\n", name, name);
+}
+
+int main(int argc, char **argv) {
+    if (argc != 3) {
+        fprintf(stderr, "usage: %s <out.h> <dir>\n", argv[0]);
+        return 1;
+    }
+
+    wm_host_image = calloc(FULL_REGION_PAGES, 4096);
+    FILE *out = fopen(argv[1], "w");
+    if (!wm_host_image || !out) {
+        perror(argv[1]);
+        return 1;
+    }
+
+    fprintf(out, "/* Generated by tools/wmimage.c -- do not edit. */\n\n");
+    fprintf(out, "#ifndef REPL_IMAGE_H\n#define REPL_IMAGE_H\n\n");
+    fprintf(out, "#include \"weirdmachine.h\"\n");
+
+    for (size_t i = 0; i < sizeof(programs) / sizeof(programs[0]); i++) {
+        memset(wm_host_image, 0, (size_t)FULL_REGION_PAGES * 4096);
+        if (wm_load_program(programs[i].prog) != 0) {
+            fprintf(stderr, "%s: program does not fit\n", programs[i].name);
+            return 1;
+        }
+        write_image(out, programs[i].name);
+        if (write_raw(argv[2], programs[i].name, image_pages(self())) != 0
+            || write_layout(argv[2], programs[i].name) != 0) {
+            perror(programs[i].name);
+            return 1;
+        }
+    }
+
+    fprintf(out, "\n#endif /* REPL_IMAGE_H */\n");
+    return fclose(out) == 0 ? 0 : 1;
+}